@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <new>
 #include <fstream>
 #include <sstream>
 #include <cmath>
@@ -9,770 +10,6506 @@
 #include <numeric>
 #include <iomanip>
 #include <map>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <random>
+#include <cstdint>
+#include <filesystem>
+#include <deque>
+#include <limits>
+#include <atomic>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
 #include <direct.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LR_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// Phase timers and counters are compiled in unless LR_DISABLE_METRICS is
+// defined; then every LR_METRICS_* macro expands to nothing
+#ifndef LR_DISABLE_METRICS
+#define LR_METRICS_ENABLED 1
+#endif
 
 using namespace std;
 
-// Dataset Class
-class Dataset {
+// Peak resident set size of this process so far, in bytes
+size_t peakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+#ifdef LR_METRICS_ENABLED
+// RunMetrics - process-wide counters, gauges and phase timers for one run.
+// Recording is off until setEnabled(true); while off each record call is a
+// single relaxed atomic load. Phases are coarse (a load, a training run, an
+// evaluation), never per row, so the mutex is not on any hot path.
+class RunMetrics {
+public:
+    struct PhaseTiming {
+        uint64_t calls = 0;
+        double total_seconds = 0.0;
+        double max_seconds = 0.0;
+    };
+
 private:
-    vector<double> x_values;
-    vector<double> y_values;
-    string x_label;
-    string y_label;
+    atomic<bool> enabled;
+    mutex metrics_mutex;
+    map<string, double> counters;
+    map<string, double> gauges;
+    map<string, PhaseTiming> phases;
+    
+    RunMetrics() : enabled(false) {}
 
 public:
-    Dataset() : x_label("X"), y_label("Y") {}
+    static RunMetrics& instance() {
+        static RunMetrics metrics;
+        return metrics;
+    }
     
-    void loadFromCSV(const string& filename) {
-        x_values.clear();
-        y_values.clear();
-        
-        ifstream file(filename);
-        if (!file.is_open()) {
-            throw runtime_error("Cannot open file: " + filename);
-        }
-        
-        string line;
-        // Skip header if exists
-        if (getline(file, line)) {
-            istringstream header_stream(line);
-            string x_header, y_header;
-            if (getline(header_stream, x_header, ',') && 
-                getline(header_stream, y_header, ',')) {
-                x_label = x_header;
-                y_label = y_header;
-            } else {
-                // Reset to read first line as data
-                file.clear();
-                file.seekg(0);
-            }
-        }
-        
-        while (getline(file, line)) {
-            istringstream ss(line);
-            string x_str, y_str;
-            
-            if (getline(ss, x_str, ',') && getline(ss, y_str, ',')) {
-                try {
-                    double x = stod(x_str);
-                    double y = stod(y_str);
-                    x_values.push_back(x);
-                    y_values.push_back(y);
-                } catch (const exception& e) {
-                    cerr << "Warning: Invalid data in line: " << line << endl;
-                }
-            }
+    void setEnabled(bool on) { enabled.store(on, memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(memory_order_relaxed); }
+    
+    void add(const char* name, double value) {
+        if (!isEnabled()) {
+            return;
         }
-        
-        if (x_values.empty()) {
-            throw runtime_error("No valid data found in file: " + filename);
+        lock_guard<mutex> lock(metrics_mutex);
+        counters[name] += value;
+    }
+    
+    void set(const char* name, double value) {
+        if (!isEnabled()) {
+            return;
         }
+        lock_guard<mutex> lock(metrics_mutex);
+        gauges[name] = value;
     }
     
-    void addDataPoint(double x, double y) {
-        x_values.push_back(x);
-        y_values.push_back(y);
+    void recordPhase(const char* name, double seconds) {
+        lock_guard<mutex> lock(metrics_mutex);
+        PhaseTiming& phase = phases[name];
+        ++phase.calls;
+        phase.total_seconds += seconds;
+        phase.max_seconds = max(phase.max_seconds, seconds);
     }
     
-    const vector<double>& getXValues() const { return x_values; }
-    const vector<double>& getYValues() const { return y_values; }
-    size_t getSize() const { return x_values.size(); }
-    void setLabels(const string& x_label, const string& y_label) {
-        this->x_label = x_label;
-        this->y_label = y_label;
+    void writeJSON(ostream& out) {
+        lock_guard<mutex> lock(metrics_mutex);
+        gauges["peak_rss_bytes"] = static_cast<double>(peakResidentBytes());
+        
+        auto write_values = [&](const map<string, double>& values) {
+            size_t i = 0;
+            for (const auto& entry : values) {
+                out << (i++ ? ", " : "") << "\"" << entry.first << "\": " << entry.second;
+            }
+        };
+        
+        out << setprecision(12) << "{\"counters\": {";
+        write_values(counters);
+        out << "}, \"gauges\": {";
+        write_values(gauges);
+        out << "}, \"phases\": {";
+        size_t i = 0;
+        for (const auto& entry : phases) {
+            out << (i++ ? ", " : "") << "\"" << entry.first << "\": {\"calls\": " << entry.second.calls
+                << ", \"total_seconds\": " << entry.second.total_seconds
+                << ", \"max_seconds\": " << entry.second.max_seconds << "}";
+        }
+        out << "}}\n";
     }
-    string getXLabel() const { return x_label; }
-    string getYLabel() const { return y_label; }
     
-    void displaySummary() const {
-        cout << "\n*** Dataset Summary ***" << endl;
-        cout << "Size: " << getSize() << " data points" << endl;
-        cout << "X Label: " << x_label << endl;
-        cout << "Y Label: " << y_label << endl;
+    // Prometheus text exposition format, metric names prefixed with "lr_"
+    void writePrometheus(ostream& out) {
+        lock_guard<mutex> lock(metrics_mutex);
+        gauges["peak_rss_bytes"] = static_cast<double>(peakResidentBytes());
+        out << setprecision(12);
         
-        if (!x_values.empty()) {
-            auto x_minmax = minmax_element(x_values.begin(), x_values.end());
-            auto y_minmax = minmax_element(y_values.begin(), y_values.end());
-            
-            cout << "X Range: [" << *x_minmax.first << ", " << *x_minmax.second << "]" << endl;
-            cout << "Y Range: [" << *y_minmax.first << ", " << *y_minmax.second << "]" << endl;
+        for (const auto& entry : counters) {
+            out << "# TYPE lr_" << entry.first << "_total counter\n"
+                << "lr_" << entry.first << "_total " << entry.second << "\n";
+        }
+        for (const auto& entry : gauges) {
+            out << "# TYPE lr_" << entry.first << " gauge\n"
+                << "lr_" << entry.first << " " << entry.second << "\n";
+        }
+        if (!phases.empty()) {
+            out << "# TYPE lr_phase_calls_total counter\n";
+            for (const auto& entry : phases) {
+                out << "lr_phase_calls_total{phase=\"" << entry.first << "\"} " << entry.second.calls << "\n";
+            }
+            out << "# TYPE lr_phase_seconds_total counter\n";
+            for (const auto& entry : phases) {
+                out << "lr_phase_seconds_total{phase=\"" << entry.first << "\"} " << entry.second.total_seconds << "\n";
+            }
+            out << "# TYPE lr_phase_seconds_max gauge\n";
+            for (const auto& entry : phases) {
+                out << "lr_phase_seconds_max{phase=\"" << entry.first << "\"} " << entry.second.max_seconds << "\n";
+            }
         }
     }
 };
 
-// RegressionModel Base Class
-class RegressionModel {
-protected:
-    double slope;
-    double intercept;
-    double mse;
+// Times the enclosing scope on the monotonic clock as one call of a phase
+class ScopedPhaseTimer {
+private:
+    const char* name;
+    bool active;
+    chrono::steady_clock::time_point start_time;
 
 public:
-    RegressionModel() : slope(0), intercept(0), mse(0) {}
-    virtual ~RegressionModel() = default;
-    
-    virtual void train(const Dataset& dataset) = 0;
-    
-    double predict(double x) const {
-        return slope * x + intercept;
-    }
-    
-    double calculateMSE(const Dataset& dataset) const {
-        const auto& x_vals = dataset.getXValues();
-        const auto& y_vals = dataset.getYValues();
-        
-        if (x_vals.size() != y_vals.size() || x_vals.empty()) {
-            return 0.0;
-        }
-        
-        double sum_squared_errors = 0.0;
-        for (size_t i = 0; i < x_vals.size(); ++i) {
-            double prediction = predict(x_vals[i]);
-            double error = y_vals[i] - prediction;
-            sum_squared_errors += error * error;
+    explicit ScopedPhaseTimer(const char* name)
+        : name(name), active(RunMetrics::instance().isEnabled()) {
+        if (active) {
+            start_time = chrono::steady_clock::now();
         }
-        
-        return sum_squared_errors / x_vals.size();
     }
     
-    double getSlope() const { return slope; }
-    double getIntercept() const { return intercept; }
-    double getMSE() const { return mse; }
-    
-    string getEquation() const {
-        stringstream ss;
-        ss << fixed << setprecision(4);
-        ss << "y = " << slope << " * x + " << intercept;
-        return ss.str();
+    ~ScopedPhaseTimer() {
+        if (active) {
+            RunMetrics::instance().recordPhase(
+                name, chrono::duration<double>(chrono::steady_clock::now() - start_time).count());
+        }
     }
     
-    void displayResults() const {
-        cout << "\n*** Regression Results ***" << endl;
-        cout << "Equation: " << getEquation() << endl;
-        cout << "Slope: " << slope << endl;
-        cout << "Intercept: " << intercept << endl;
-        cout << "Mean Squared Error: " << mse << endl;
-    }
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
 };
 
-// GradientDescentModel Class
-class GradientDescentModel : public RegressionModel {
+#define LR_METRICS_CONCAT_INNER(a, b) a##b
+#define LR_METRICS_CONCAT(a, b) LR_METRICS_CONCAT_INNER(a, b)
+#define LR_METRICS_PHASE(name) ScopedPhaseTimer LR_METRICS_CONCAT(lr_phase_timer_, __LINE__)(name)
+#define LR_METRICS_COUNT(name, value) RunMetrics::instance().add(name, static_cast<double>(value))
+#define LR_METRICS_GAUGE(name, value) RunMetrics::instance().set(name, static_cast<double>(value))
+#else
+#define LR_METRICS_PHASE(name) ((void)0)
+#define LR_METRICS_COUNT(name, value) ((void)0)
+#define LR_METRICS_GAUGE(name, value) ((void)0)
+#endif
+
+// MappedFile Class - read-only memory mapping of a whole file
+class MappedFile {
 private:
-    double learning_rate;
-    int max_iterations;
-    double tolerance;
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file_handle;
+    HANDLE mapping_handle;
+#else
+    int fd;
+#endif
 
 public:
-    GradientDescentModel(double lr = 0.01, int max_iter = 1000, double tol = 1e-6) 
-        : learning_rate(lr), max_iterations(max_iter), tolerance(tol) {}
-    
-    void train(const Dataset& dataset) override {
-        const auto& x_vals = dataset.getXValues();
-        const auto& y_vals = dataset.getYValues();
-        
-        if (x_vals.empty()) {
-            throw runtime_error("Dataset is empty");
+    explicit MappedFile(const string& filename) : data(nullptr), size(0) {
+#ifdef _WIN32
+        mapping_handle = NULL;
+        file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file_handle == INVALID_HANDLE_VALUE) {
+            throw runtime_error("Cannot open file: " + filename);
         }
         
-        // Initialize parameters
-        slope = 0.0;
-        intercept = 0.0;
-        
-        int n = x_vals.size();
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle, &file_size)) {
+            CloseHandle(file_handle);
+            throw runtime_error("Cannot read size of file: " + filename);
+        }
+        size = static_cast<size_t>(file_size.QuadPart);
         
-        for (int iter = 0; iter < max_iterations; ++iter) {
-            double slope_gradient = 0.0;
-            double intercept_gradient = 0.0;
-            
-            // Calculate gradients
-            for (int i = 0; i < n; ++i) {
-                double prediction = slope * x_vals[i] + intercept;
-                double error = prediction - y_vals[i];
-                
-                slope_gradient += (2.0 / n) * error * x_vals[i];
-                intercept_gradient += (2.0 / n) * error;
+        // Windows refuses to map empty files, so leave data as nullptr
+        if (size > 0) {
+            mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping_handle != NULL) {
+                data = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
             }
-            
-            // Update parameters
-            double new_slope = slope - learning_rate * slope_gradient;
-            double new_intercept = intercept - learning_rate * intercept_gradient;
-            
-            // Check for convergence
-            if (abs(new_slope - slope) < tolerance && abs(new_intercept - intercept) < tolerance) {
-                break;
+            if (!data) {
+                if (mapping_handle != NULL) CloseHandle(mapping_handle);
+                CloseHandle(file_handle);
+                throw runtime_error("Cannot map file: " + filename);
             }
-            
-            slope = new_slope;
-            intercept = new_intercept;
         }
-        
-        mse = calculateMSE(dataset);
-    }
-    
-    void setParameters(double lr, int max_iter, double tol) {
-        learning_rate = lr;
-        max_iterations = max_iter;
-        tolerance = tol;
-    }
-};
-
-// LeastSquaresModel Class
-class LeastSquaresModel : public RegressionModel {
-public:
-    void train(const Dataset& dataset) override {
-        const auto& x_vals = dataset.getXValues();
-        const auto& y_vals = dataset.getYValues();
-        
-        if (x_vals.empty()) {
-            throw runtime_error("Dataset is empty");
+#else
+        fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open file: " + filename);
         }
         
-        int n = x_vals.size();
-        
-        // Calculate means
-        double x_mean = accumulate(x_vals.begin(), x_vals.end(), 0.0) / n;
-        double y_mean = accumulate(y_vals.begin(), y_vals.end(), 0.0) / n;
-        
-        // Calculate slope and intercept using least squares formula
-        double numerator = 0.0;
-        double denominator = 0.0;
-        
-        for (int i = 0; i < n; ++i) {
-            numerator += (x_vals[i] - x_mean) * (y_vals[i] - y_mean);
-            denominator += (x_vals[i] - x_mean) * (x_vals[i] - x_mean);
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw runtime_error("Cannot read size of file: " + filename);
         }
+        size = static_cast<size_t>(info.st_size);
         
-        slope = numerator / denominator;
-        intercept = y_mean - slope * x_mean;
-        
-        mse = calculateMSE(dataset);
+        // mmap refuses zero-length mappings, so leave data as nullptr
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw runtime_error("Cannot map file: " + filename);
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapped);
+        }
+#endif
     }
+    
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping_handle != NULL) CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+#else
+        if (data) munmap(const_cast<char*>(data), size);
+        close(fd);
+#endif
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const char* begin() const { return data; }
+    const char* end() const { return data + size; }
+    size_t getSize() const { return size; }
 };
 
-// LinearRegression Main Class
-class LinearRegression {
-private:
-    unique_ptr<RegressionModel> model;
-    Dataset dataset;
-    bool is_trained;
+// CSV Parsing Helpers - parse rows in place without building strings
+enum class CSVRowStatus { Skipped, Invalid, Valid };
 
-public:
-    LinearRegression() : is_trained(false) {}
+// Return the end of the line starting at begin (the '\n' or end of buffer)
+inline const char* findLineEnd(const char* begin, const char* end) {
+    const void* newline = memchr(begin, '\n', end - begin);
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+// Drop the '\r' of a CRLF line, as text-mode getline does on Windows
+inline const char* trimCarriageReturn(const char* begin, const char* end) {
+    return (end > begin && *(end - 1) == '\r') ? end - 1 : end;
+}
+
+// Split a line into its first two comma-separated fields, following the
+// getline(ss, field, ',') rules used by Dataset::loadFromCSV
+inline bool splitCSVFields(const char* begin, const char* end,
+                           const char*& x_end, const char*& y_begin, const char*& y_end) {
+    const char* comma = static_cast<const char*>(memchr(begin, ',', end - begin));
+    if (!comma || comma + 1 == end) {
+        return false;
+    }
     
-    void loadData(const string& filename) {
-        dataset.loadFromCSV(filename);
-        is_trained = false;
+    x_end = comma;
+    y_begin = comma + 1;
+    const char* second_comma = static_cast<const char*>(memchr(y_begin, ',', end - y_begin));
+    y_end = second_comma ? second_comma : end;
+    return true;
+}
+
+// Parse a number the way stod does: leading whitespace and '+' are allowed,
+// trailing text is ignored
+inline bool parseCSVNumber(const char* begin, const char* end, double& value) {
+    while (begin < end && isspace(static_cast<unsigned char>(*begin))) {
+        ++begin;
+    }
+    if (begin < end && *begin == '+' && (begin + 1 == end || *(begin + 1) != '-')) {
+        ++begin;
     }
     
-    void addDataPoint(double x, double y) {
-        dataset.addDataPoint(x, y);
-        is_trained = false;
+    // from_chars has no 0x prefix and would read "0x10" as 0; hand hex
+    // values to strtod, which is what stod uses
+    const char* digits = begin < end && *begin == '-' ? begin + 1 : begin;
+    if (end - digits >= 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        string field(begin, end);
+        char* parsed_end = nullptr;
+        errno = 0;
+        value = strtod(field.c_str(), &parsed_end);
+        return parsed_end != field.c_str() && errno != ERANGE;
     }
     
-    void useGradientDescent(double lr = 0.01, int max_iter = 1000, double tol = 1e-6) {
-        model = make_unique<GradientDescentModel>(lr, max_iter, tol);
-        is_trained = false;
+    auto result = from_chars(begin, end, value);
+    return result.ec == errc();
+}
+
+inline CSVRowStatus parseCSVRow(const char* begin, const char* end, double& x, double& y) {
+    const char* x_end;
+    const char* y_begin;
+    const char* y_end;
+    
+    if (!splitCSVFields(begin, end, x_end, y_begin, y_end)) {
+        return CSVRowStatus::Skipped;
+    }
+    if (!parseCSVNumber(begin, x_end, x) || !parseCSVNumber(y_begin, y_end, y)) {
+        return CSVRowStatus::Invalid;
+    }
+    return CSVRowStatus::Valid;
+}
+
+// Read the labels from the first line if it has two fields and return
+// where the data rows start, mirroring the header rule of loadFromCSV
+inline const char* skipCSVHeader(const char* begin, const char* end,
+                                 string& x_label, string& y_label) {
+    if (begin >= end) {
+        return begin;
     }
     
-    void useLeastSquares() {
-        model = make_unique<LeastSquaresModel>();
-        is_trained = false;
+    const char* line_end = findLineEnd(begin, end);
+    const char* content_end = trimCarriageReturn(begin, line_end);
+    const char* x_end;
+    const char* y_begin;
+    const char* y_end;
+    
+    if (!splitCSVFields(begin, content_end, x_end, y_begin, y_end)) {
+        return begin;
     }
+    x_label.assign(begin, x_end);
+    y_label.assign(y_begin, y_end);
+    return min(line_end + 1, end);
+}
+
+// Parse every line in [begin, end), appending valid rows and remembering
+// the span of each invalid line so warnings can be reported in file order.
+// Values are parsed as double and rounded once when the column holds float.
+// Column is any container with value_type and push_back.
+template <typename Column>
+inline void parseCSVRange(const char* begin, const char* end,
+                          Column& x_out, Column& y_out,
+                          vector<pair<const char*, const char*>>& invalid_lines) {
+    typedef typename Column::value_type T;
+    const char* cursor = begin;
     
-    void trainModel() {
-        if (!model) {
-            throw runtime_error("No regression model selected. Use useGradientDescent() or useLeastSquares() first.");
-        }
+    while (cursor < end) {
+        const char* line_end = findLineEnd(cursor, end);
+        const char* content_end = trimCarriageReturn(cursor, line_end);
+        double x, y;
         
-        if (dataset.getSize() < 2) {
-            throw runtime_error("Insufficient data for training. Need at least 2 data points.");
+        CSVRowStatus status = parseCSVRow(cursor, content_end, x, y);
+        if (status == CSVRowStatus::Valid) {
+            x_out.push_back(static_cast<T>(x));
+            y_out.push_back(static_cast<T>(y));
+        } else if (status == CSVRowStatus::Invalid) {
+            invalid_lines.emplace_back(cursor, content_end);
         }
-        
-        cout << "Training model..." << endl;
-        model->train(dataset);
-        is_trained = true;
-        cout << "Training completed!" << endl;
+        cursor = line_end + 1;
     }
-    
-    double predict(double x) const {
-        if (!is_trained || !model) {
-            throw runtime_error("Model not trained. Call trainModel() first.");
-        }
-        return model->predict(x);
+}
+
+inline void reportInvalidCSVLines(const vector<pair<const char*, const char*>>& invalid_lines) {
+    LR_METRICS_COUNT("bad_rows", invalid_lines.size());
+    for (const auto& line : invalid_lines) {
+        cerr << "Warning: Invalid data in line: ";
+        cerr.write(line.first, line.second - line.first);
+        cerr << endl;
     }
+}
+
+// Read a stream in large blocks and call handle_line(begin, end) for each
+// line (without its line ending), holding only one block in memory
+template <typename LineHandler>
+void forEachStreamLine(istream& in, LineHandler&& handle_line) {
+    vector<char> buffer(1 << 20);
+    size_t pending = 0;
     
-    void displayResults() const {
-        if (!is_trained || !model) {
-            throw runtime_error("Model not trained. Call trainModel() first.");
+    while (true) {
+        if (pending == buffer.size()) {
+            buffer.resize(buffer.size() * 2);  // a single line longer than the buffer
         }
-        model->displayResults();
+        in.read(buffer.data() + pending, buffer.size() - pending);
+        size_t filled = pending + static_cast<size_t>(in.gcount());
+        if (filled == pending) {
+            break;
+        }
+        
+        const char* cursor = buffer.data();
+        const char* end = buffer.data() + filled;
+        const char* complete_end = end;
+        while (complete_end > cursor && *(complete_end - 1) != '\n') {
+            --complete_end;
+        }
+        
+        if (complete_end > cursor) {
+            while (cursor < complete_end) {
+                const char* line_end = findLineEnd(cursor, complete_end);
+                handle_line(cursor, trimCarriageReturn(cursor, line_end));
+                cursor = line_end + 1;
+            }
+        }
+        
+        pending = end - cursor;
+        memmove(buffer.data(), cursor, pending);
     }
     
-    void displayDatasetSummary() const {
-        dataset.displaySummary();
+    // Last line without a trailing newline
+    if (pending > 0) {
+        const char* begin = buffer.data();
+        handle_line(begin, trimCarriageReturn(begin, begin + pending));
     }
+}
+
+// Estimate the number of rows in total_bytes of CSV from the average length
+// of the first lines in [begin, end)
+inline size_t estimateCSVRows(const char* begin, const char* end, uint64_t total_bytes) {
+    const size_t sample_lines = 64;
+    const char* cursor = begin;
+    size_t lines = 0;
     
-    bool isModelTrained() const {
-        return is_trained;
+    while (cursor < end && lines < sample_lines) {
+        cursor = findLineEnd(cursor, end) + 1;
+        ++lines;
     }
     
-    // ADD THIS MISSING METHOD
-    const Dataset& getDataset() const {
-        return dataset;
+    if (lines == 0) {
+        return 0;
     }
-};
+    double average_length = static_cast<double>(min(cursor, end) - begin) / lines;
+    return static_cast<size_t>(total_bytes / average_length) + 1;
+}
 
-// Category definitions with all datasets
-map<string, pair<string, string>> categories = {
-    {"1", {"Education", "Study hours vs Exam scores"}},
-    {"2", {"Real Estate", "House size vs Price"}},
-    {"3", {"Business", "Advertising budget vs Sales"}},
-    {"4", {"Healthcare", "Treatment duration vs Recovery rate"}},
-    {"5", {"Sports", "Training hours vs Performance score"}},
-    {"6", {"Salary Prediction", "Years of experience vs Salary"}},
-    {"7", {"Temperature Analysis", "Temperature vs Ice Cream Sales"}},
-    {"8", {"Car Valuation", "Car age vs Price"}},
-    {"9", {"Custom", "Your own dataset"}}
-};
-
-// Function to display categories
-void displayCategories() {
-    cout << "\n*** SELECT CATEGORY ***" << endl;
-    cout << "==========================================" << endl;
-    for (const auto& category : categories) {
-        cout << category.first << ". " << category.second.first << endl;
-        cout << "   - " << category.second.second << endl;
-    }
-    cout << "==========================================" << endl;
+inline size_t estimateCSVRows(const char* begin, const char* end) {
+    return estimateCSVRows(begin, end, end - begin);
 }
 
-// Function to get category-specific prompt
-pair<string, string> getCategoryPrompts(const string& categoryId) {
-    map<string, pair<string, string>> prompts = {
-        {"1", {"study hours", "exam score"}},
-        {"2", {"house size (sqft)", "price ($)"}},
-        {"3", {"advertising budget ($)", "sales amount ($)"}},
-        {"4", {"treatment duration (days)", "recovery rate (%)"}},
-        {"5", {"training hours", "performance score"}},
-        {"6", {"years of experience", "salary ($)"}},
-        {"7", {"temperature (C)", "ice cream sales"}},
-        {"8", {"car age (years)", "price ($)"}},
-        {"9", {"input value", "output value"}}
-    };
+// ChunkPool Class - hands out fixed-size, 64-byte aligned blocks and takes
+// them back for reuse, so growing columns never reallocate or copy what is
+// already stored. Shared by every column of a Dataset; thread-safe, since
+// the parallel loader fills several columns at once.
+class ChunkPool {
+private:
+    vector<void*> free_blocks;
+    size_t allocated_blocks;
+    mutex pool_mutex;
     
-    return prompts[categoryId];
-}
+    static void* allocateBlock() {
+        return ::operator new(BLOCK_BYTES, align_val_t(BLOCK_ALIGNMENT));
+    }
+    static void freeBlock(void* block) {
+        ::operator delete(block, align_val_t(BLOCK_ALIGNMENT));
+    }
 
-// Function to create sample CSV for a category
-void createSampleCSV(const string& categoryId, const string& filename) {
-    ofstream file(filename);
+public:
+    static constexpr size_t BLOCK_BYTES = 1 << 19;  // 64K doubles or 128K floats
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
     
-    if (categoryId == "1") {
-        // Education sample
-        file << "Study_Hours,Exam_Score" << endl;
-        file << "1,45" << endl;
-        file << "2,55" << endl;
-        file << "3,65" << endl;
-        file << "4,75" << endl;
-        file << "5,85" << endl;
-        file << "6,80" << endl;
-        file << "7,90" << endl;
-        file << "8,95" << endl;
-        file << "9,92" << endl;
-        file << "10,98" << endl;
-    }
-    else if (categoryId == "2") {
-        // Real Estate sample
-        file << "Size_sqft,Price" << endl;
-        file << "800,250000" << endl;
-        file << "1000,300000" << endl;
-        file << "1200,350000" << endl;
-        file << "1500,400000" << endl;
-        file << "1800,450000" << endl;
-        file << "2000,500000" << endl;
-        file << "2200,520000" << endl;
-        file << "2500,580000" << endl;
+    ChunkPool() : allocated_blocks(0) {}
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+    
+    // Every acquired block must have been released by now
+    ~ChunkPool() {
+        for (void* block : free_blocks) {
+            freeBlock(block);
+        }
     }
-    else if (categoryId == "3") {
-        // Business sample
-        file << "Advertising_Budget,Sales" << endl;
-        file << "500,3000" << endl;
-        file << "1000,5000" << endl;
-        file << "1500,6500" << endl;
-        file << "2000,8000" << endl;
-        file << "2500,9500" << endl;
-        file << "3000,12000" << endl;
-        file << "4000,15000" << endl;
-        file << "5000,18000" << endl;
+    
+    void* acquire() {
+        lock_guard<mutex> lock(pool_mutex);
+        if (free_blocks.empty()) {
+            void* block = allocateBlock();
+            ++allocated_blocks;
+            return block;
+        }
+        void* block = free_blocks.back();
+        free_blocks.pop_back();
+        return block;
     }
-    else if (categoryId == "4") {
-        // Healthcare sample
-        file << "Treatment_Days,Recovery_Rate" << endl;
-        file << "3,20" << endl;
-        file << "5,30" << endl;
-        file << "7,40" << endl;
-        file << "10,50" << endl;
-        file << "15,65" << endl;
-        file << "20,75" << endl;
-        file << "25,80" << endl;
-        file << "30,85" << endl;
+    
+    void release(void* block) {
+        lock_guard<mutex> lock(pool_mutex);
+        free_blocks.push_back(block);
     }
-    else if (categoryId == "5") {
-        // Sports sample
-        file << "Training_Hours,Performance_Score" << endl;
-        file << "5,40" << endl;
-        file << "10,60" << endl;
-        file << "15,65" << endl;
-        file << "20,75" << endl;
-        file << "25,80" << endl;
-        file << "30,85" << endl;
-        file << "35,88" << endl;
-        file << "40,90" << endl;
+    
+    // Allocate up front so that `blocks` more acquires need no allocation
+    void reserve(size_t blocks) {
+        lock_guard<mutex> lock(pool_mutex);
+        free_blocks.reserve(blocks);
+        while (free_blocks.size() < blocks) {
+            free_blocks.push_back(allocateBlock());
+            ++allocated_blocks;
+        }
     }
-    else if (categoryId == "6") {
-        // Salary sample
-        file << "Years_Experience,Salary" << endl;
-        file << "1,35000" << endl;
-        file << "2,40000" << endl;
-        file << "3,45000" << endl;
-        file << "4,50000" << endl;
-        file << "5,55000" << endl;
-        file << "6,60000" << endl;
-        file << "7,65000" << endl;
-        file << "8,70000" << endl;
+    
+    // Return unused blocks to the system, e.g. after an over-estimated reserve
+    void trim() {
+        lock_guard<mutex> lock(pool_mutex);
+        for (void* block : free_blocks) {
+            freeBlock(block);
+        }
+        allocated_blocks -= free_blocks.size();
+        free_blocks.clear();
+        free_blocks.shrink_to_fit();
     }
-    else if (categoryId == "7") {
-        // Temperature sample
-        file << "Temperature,Ice_Cream_Sales" << endl;
-        file << "15,100" << endl;
-        file << "18,120" << endl;
-        file << "20,150" << endl;
-        file << "22,180" << endl;
-        file << "25,220" << endl;
-        file << "28,260" << endl;
-        file << "30,300" << endl;
-        file << "32,320" << endl;
+    
+    size_t getAllocatedBytes() {
+        lock_guard<mutex> lock(pool_mutex);
+        return allocated_blocks * BLOCK_BYTES;
     }
-    else if (categoryId == "8") {
-        // Car valuation sample
-        file << "Car_Age,Price" << endl;
-        file << "0,30000" << endl;
-        file << "1,27000" << endl;
-        file << "2,24000" << endl;
-        file << "3,22000" << endl;
-        file << "4,20000" << endl;
-        file << "5,18000" << endl;
-        file << "6,16000" << endl;
-        file << "7,14000" << endl;
+};
+
+// BasicColumnView Class - read-only view of one column of values stored as
+// equal-sized chunks (the last one partial), or as one contiguous block for
+// a memory-mapped binary dataset. Elements are double or float depending on
+// the dataset's StoragePrecision; operator[] always widens to double. Bulk
+// work goes through forEachSpan so kernels see contiguous arrays.
+template <typename T>
+class BasicColumnView {
+private:
+    const T* const* chunks;  // nullptr when the column is the single block `base`
+    const T* base;
+    size_t count;
+    unsigned chunk_shift;    // log2 of the rows per chunk
+
+public:
+    typedef T value_type;
+    
+    BasicColumnView(const T* const* chunks, size_t count, unsigned chunk_shift)
+        : chunks(chunks), base(nullptr), count(count), chunk_shift(chunk_shift) {}
+    BasicColumnView(const T* values, size_t count)
+        : chunks(nullptr), base(values), count(count), chunk_shift(sizeof(size_t) * 8 - 1) {}
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    double operator[](size_t i) const {
+        return chunkData(i >> chunk_shift)[i & ((size_t(1) << chunk_shift) - 1)];
     }
-    else if (categoryId == "9") {
-        // Custom sample
-        file << "Input,Output" << endl;
-        file << "1,10" << endl;
-        file << "2,20" << endl;
-        file << "3,30" << endl;
-        file << "4,40" << endl;
-        file << "5,50" << endl;
-        file << "6,60" << endl;
-        file << "7,70" << endl;
-        file << "8,80" << endl;
+    
+    unsigned getChunkShift() const { return chunk_shift; }
+    size_t chunkCount() const {
+        return chunks ? (count + (size_t(1) << chunk_shift) - 1) >> chunk_shift : (count > 0 ? 1 : 0);
     }
+    const T* chunkData(size_t k) const { return chunks ? chunks[k] : base; }
     
-    file.close();
-    cout << "*** SUCCESS: Created sample file: " << filename << endl;
-    cout << "*** INFO: Sample data created with realistic values for " << categories[categoryId].first << endl;
-}
+    // Call span(values, rows) for each contiguous run of rows [begin, end), in order
+    template <typename SpanHandler>
+    void forEachSpan(size_t begin, size_t end, SpanHandler&& span) const {
+        while (begin < end) {
+            size_t k = begin >> chunk_shift;
+            size_t chunk_end = min(end, (k + 1) << chunk_shift);
+            span(chunkData(k) + (begin - (k << chunk_shift)), chunk_end - begin);
+            begin = chunk_end;
+        }
+    }
+};
 
-// Function to check if file exists
-bool fileExists(const string& filename) {
-    ifstream file(filename);
-    return file.good();
+// Call span(x, y, rows) for each contiguous run of rows [begin, end) of two
+// columns with the same layout (x and y of one Dataset)
+template <typename T, typename SpanHandler>
+void forEachRowSpan(const BasicColumnView<T>& x_vals, const BasicColumnView<T>& y_vals,
+                    size_t begin, size_t end, SpanHandler&& span) {
+    unsigned shift = x_vals.getChunkShift();
+    while (begin < end) {
+        size_t k = begin >> shift;
+        size_t chunk_end = min(end, (k + 1) << shift);
+        size_t offset = begin - (k << shift);
+        span(x_vals.chunkData(k) + offset, y_vals.chunkData(k) + offset, chunk_end - begin);
+        begin = chunk_end;
+    }
 }
 
-// Function to display dataset suggestions
-void displayDatasetSuggestions(const string& categoryId) {
-    map<string, string> suggestions = {
-        {"1", "student_data.csv, education_data.csv, marks_data.csv"},
-        {"2", "housing_data.csv, real_estate_data.csv, property_data.csv"},
-        {"3", "business_data.csv, sales_data.csv, advertising_data.csv"},
-        {"4", "healthcare_data.csv, medical_data.csv, recovery_data.csv"},
-        {"5", "sports_data.csv, training_data.csv, performance_data.csv"},
-        {"6", "salary_data.csv, experience_data.csv, income_data.csv"},
-        {"7", "temperature_data.csv, weather_data.csv, sales_data.csv"},
-        {"8", "car_data.csv, vehicle_data.csv, auto_data.csv"},
-        {"9", "Any CSV file with two columns (input,output)"}
-    };
-    
-    cout << "*** SUGGESTION: " << suggestions[categoryId] << endl;
+// Smallest and largest value of a non-empty column
+template <typename T>
+pair<double, double> columnRange(const BasicColumnView<T>& values) {
+    T low = values.chunkData(0)[0];
+    T high = low;
+    values.forEachSpan(0, values.size(), [&](const T* span, size_t n) {
+        auto span_range = minmax_element(span, span + n);
+        low = min(low, *span_range.first);
+        high = max(high, *span_range.second);
+    });
+    return {low, high};
 }
 
-// Function to show current directory (Windows)
-void showCurrentDirectory() {
-    char buffer[1024];
-    if (_getcwd(buffer, sizeof(buffer)) != NULL) {
-        cout << "*** Current directory: " << buffer << endl;
+// ChunkedColumn Class - append-only column of T in ChunkPool blocks. Full
+// chunks never move, so appending costs no copies and peak memory grows by
+// at most one block at a time, unlike a vector's geometric regrowth.
+template <typename T>
+class ChunkedColumn {
+private:
+    shared_ptr<ChunkPool> pool;
+    vector<T*> chunks;  // ceil(count / CHUNK_ROWS) blocks
+    size_t count;
+    
+    void addChunk() {
+        chunks.push_back(static_cast<T*>(pool->acquire()));
     }
-}
-
-// Function to create all sample datasets at once
-void createAllSampleDatasets() {
-    cout << "\n*** CREATING ALL SAMPLE DATASETS ***" << endl;
-    createSampleCSV("1", "student_data.csv");
-    createSampleCSV("2", "housing_data.csv");
-    createSampleCSV("3", "business_data.csv");
-    createSampleCSV("4", "healthcare_data.csv");
-    createSampleCSV("5", "sports_data.csv");
-    createSampleCSV("6", "salary_data.csv");
-    createSampleCSV("7", "temperature_data.csv");
-    createSampleCSV("8", "car_data.csv");
-    createSampleCSV("9", "custom_data.csv");
-    cout << "*** SUCCESS: All sample datasets created successfully!" << endl;
-}
 
-// Main category-based workflow
-void runCategoryWorkflow() {
-    LinearRegression lr;
-    string categoryId;
-    string currentCategory;
-    bool datasetsCreated = false;
+public:
+    static constexpr unsigned CHUNK_SHIFT = sizeof(T) == 8 ? 16 : 17;
+    static constexpr size_t CHUNK_ROWS = size_t(1) << CHUNK_SHIFT;
+    static_assert(CHUNK_ROWS * sizeof(T) == ChunkPool::BLOCK_BYTES, "chunk must fill one pool block");
     
-    // Show current directory
-    showCurrentDirectory();
+    typedef T value_type;
     
-    // Step 1: Ask about creating datasets FIRST
-    cout << "\nWould you like to create all sample datasets first? (y/n): ";
-    char createChoice;
-    cin >> createChoice;
+    explicit ChunkedColumn(shared_ptr<ChunkPool> pool) : pool(move(pool)), count(0) {}
+    ChunkedColumn(const ChunkedColumn&) = delete;
+    ChunkedColumn& operator=(const ChunkedColumn&) = delete;
+    ChunkedColumn(ChunkedColumn&& other) noexcept
+        : pool(other.pool), chunks(move(other.chunks)), count(other.count) {
+        other.chunks.clear();
+        other.count = 0;
+    }
+    ChunkedColumn& operator=(ChunkedColumn&& other) noexcept {
+        if (this != &other) {
+            clear();
+            pool = other.pool;
+            chunks.swap(other.chunks);
+            count = other.count;
+            other.count = 0;
+        }
+        return *this;
+    }
+    ~ChunkedColumn() { clear(); }
     
-    if (createChoice == 'y' || createChoice == 'Y') {
-        createAllSampleDatasets();
-        datasetsCreated = true;
-        cout << "\n*** NOTE: Sample datasets are now available in your current directory ***" << endl;
+    void push_back(T value) {
+        if ((count & (CHUNK_ROWS - 1)) == 0) {
+            addChunk();
+        }
+        chunks.back()[count & (CHUNK_ROWS - 1)] = value;
+        ++count;
     }
     
-    // Step 2: Category Selection
-    displayCategories();
-    cout << "Enter category number (1-9): ";
-    cin >> categoryId;
+    // Append n values, converting from U when it differs from T
+    template <typename U>
+    void append(const U* values, size_t n) {
+        while (n > 0) {
+            size_t offset = count & (CHUNK_ROWS - 1);
+            if (offset == 0) {
+                addChunk();
+            }
+            size_t take = min(n, CHUNK_ROWS - offset);
+            copy(values, values + take, chunks.back() + offset);
+            values += take;
+            count += take;
+            n -= take;
+        }
+    }
     
-    if (categories.find(categoryId) == categories.end()) {
-        cout << "*** ERROR: Invalid category selection!" << endl;
-        return;
+    // Move all of other's rows to the end. Its chunks are adopted as they
+    // are when this column ends on a chunk boundary; otherwise they are
+    // copied and handed back to the pool one by one, so either way memory
+    // never holds both copies.
+    void splice(ChunkedColumn& other) {
+        if ((count & (CHUNK_ROWS - 1)) == 0) {
+            chunks.insert(chunks.end(), other.chunks.begin(), other.chunks.end());
+            count += other.count;
+        } else {
+            for (size_t k = 0; k < other.chunks.size(); ++k) {
+                append(other.chunks[k], min(CHUNK_ROWS, other.count - k * CHUNK_ROWS));
+                other.pool->release(other.chunks[k]);
+            }
+        }
+        other.chunks.clear();
+        other.count = 0;
     }
     
-    currentCategory = categories[categoryId].first;
-    cout << "\n*** SELECTED: " << currentCategory << endl;
-    cout << "*** DESCRIPTION: " << categories[categoryId].second << endl;
+    static size_t blocksFor(size_t rows) { return (rows + CHUNK_ROWS - 1) >> CHUNK_SHIFT; }
     
-    // Step 3: File Path Handling - SMART LOGIC
-    string filepath;
-    map<string, string> defaultFiles = {
-        {"1", "student_data.csv"},
-        {"2", "housing_data.csv"},
-        {"3", "business_data.csv"},
-        {"4", "healthcare_data.csv"},
-        {"5", "sports_data.csv"},
-        {"6", "salary_data.csv"},
-        {"7", "temperature_data.csv"},
+    // Blocks still to be acquired to hold `rows` rows in total; the chunk
+    // list itself is sized for them now
+    size_t reserve(size_t rows) {
+        size_t needed = blocksFor(rows);
+        chunks.reserve(needed);
+        return needed > chunks.size() ? needed - chunks.size() : 0;
+    }
+    
+    void clear() {
+        for (T* chunk : chunks) {
+            pool->release(chunk);
+        }
+        chunks.clear();
+        count = 0;
+    }
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    BasicColumnView<T> view() const {
+        return BasicColumnView<T>(chunks.data(), count, CHUNK_SHIFT);
+    }
+};
+
+typedef BasicColumnView<double> ColumnView;
+typedef BasicColumnView<float> FloatColumnView;
+
+// How Dataset holds x and y. Float32 halves memory and the bytes every
+// training or evaluation pass reads; all sums are still accumulated in
+// double (the metrics with Kahan compensation), so the only loss is the
+// one-time rounding of each stored value to a 24-bit mantissa: relative
+// error up to 6e-8 per value. That is far below typical noise, but a
+// column with a large offset relative to its spread (e.g. timestamps, or
+// x = 1e6 + 0.01 i) loses most of its significant digits. Keep Double for
+// such data or center it before loading.
+enum class StoragePrecision { Double, Float32 };
+
+string storagePrecisionName(StoragePrecision precision) {
+    return precision == StoragePrecision::Float32 ? "float32" : "double";
+}
+
+bool parseStoragePrecision(const string& name, StoragePrecision& precision) {
+    if (name == "double" || name == "float64") {
+        precision = StoragePrecision::Double;
+    } else if (name == "float32" || name == "float") {
+        precision = StoragePrecision::Float32;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Binary columnar dataset (.lrbin) layout, native byte order:
+//   BinaryDatasetHeader | x label | y label | padding to data_offset |
+//   x[row_count] | y[row_count]
+struct BinaryDatasetHeader {
+    char magic[8];           // "LRBIN" followed by zeros
+    uint32_t version;
+    uint32_t value_size;     // bytes per stored value (8 = double, 4 = float)
+    uint64_t row_count;
+    uint32_t x_label_length;
+    uint32_t y_label_length;
+    uint64_t data_offset;    // 64-byte aligned start of the x column
+};
+
+const char BINARY_DATASET_MAGIC[8] = {'L', 'R', 'B', 'I', 'N', 0, 0, 0};
+const uint32_t BINARY_DATASET_VERSION = 1;
+const uint64_t BINARY_DATASET_ALIGNMENT = 64;
+
+// Header for row_count rows; the data starts at the first aligned offset
+// after the labels
+BinaryDatasetHeader makeBinaryDatasetHeader(uint64_t row_count, const string& x_label, const string& y_label,
+                                            uint32_t value_size = sizeof(double)) {
+    BinaryDatasetHeader header = {};
+    memcpy(header.magic, BINARY_DATASET_MAGIC, sizeof(header.magic));
+    header.version = BINARY_DATASET_VERSION;
+    header.value_size = value_size;
+    header.row_count = row_count;
+    header.x_label_length = static_cast<uint32_t>(x_label.size());
+    header.y_label_length = static_cast<uint32_t>(y_label.size());
+    
+    uint64_t labels_end = sizeof(header) + x_label.size() + y_label.size();
+    header.data_offset = (labels_end + BINARY_DATASET_ALIGNMENT - 1) / BINARY_DATASET_ALIGNMENT * BINARY_DATASET_ALIGNMENT;
+    return header;
+}
+
+// Binary cache path for a CSV file: data.csv -> data.lrbin
+string binaryCachePath(const string& csv_filename) {
+    return filesystem::path(csv_filename).replace_extension(".lrbin").string();
+}
+
+// Dataset Class
+class Dataset {
+private:
+    // In-memory columns are chunked, so loading and appending never move
+    // stored values. Only the pair matching `precision` is in use; the
+    // other stays empty.
+    shared_ptr<ChunkPool> pool;
+    ChunkedColumn<double> x_values;
+    ChunkedColumn<double> y_values;
+    ChunkedColumn<float> x_floats;
+    ChunkedColumn<float> y_floats;
+    StoragePrecision precision;
+    string x_label;
+    string y_label;
+    size_t load_bytes;
+    double load_seconds;
+    
+    // Set while the columns live in a mapped .lrbin file instead of the
+    // chunks; the element type follows `precision`
+    shared_ptr<MappedFile> mapped_file;
+    const void* mapped_x;
+    const void* mapped_y;
+    size_t mapped_rows;
+    
+    template <typename T>
+    ChunkedColumn<T>& xStorage() {
+        if constexpr (is_same<T, float>::value) return x_floats; else return x_values;
+    }
+    template <typename T>
+    ChunkedColumn<T>& yStorage() {
+        if constexpr (is_same<T, float>::value) return y_floats; else return y_values;
+    }
+    template <typename T>
+    const ChunkedColumn<T>& xStorage() const { return const_cast<Dataset*>(this)->xStorage<T>(); }
+    template <typename T>
+    const ChunkedColumn<T>& yStorage() const { return const_cast<Dataset*>(this)->yStorage<T>(); }
+    
+    void releaseMapping() {
+        mapped_file.reset();
+        mapped_x = nullptr;
+        mapped_y = nullptr;
+        mapped_rows = 0;
+    }
+    
+    void clearColumns() {
+        releaseMapping();
+        x_values.clear();
+        y_values.clear();
+        x_floats.clear();
+        y_floats.clear();
+    }
+    
+    // Pre-allocate both columns for an estimated row count; blocks left over
+    // from an over-estimate are returned by pool->trim() after the load
+    template <typename T>
+    void reserveRows(size_t rows) {
+        size_t blocks = xStorage<T>().reserve(rows) + yStorage<T>().reserve(rows);
+        pool->reserve(blocks);
+    }
+    
+    // Copy mapped columns into chunks before they are modified
+    template <typename T>
+    void copyMappedRows() {
+        BasicColumnView<T> x_vals = columnX<T>();
+        BasicColumnView<T> y_vals = columnY<T>();
+        reserveRows<T>(x_vals.size());
+        ChunkedColumn<T>& xs = xStorage<T>();
+        ChunkedColumn<T>& ys = yStorage<T>();
+        forEachRowSpan(x_vals, y_vals, 0, x_vals.size(), [&](const T* x, const T* y, size_t n) {
+            xs.append(x, n);
+            ys.append(y, n);
+        });
+    }
+    
+    void detachMapping() {
+        if (!mapped_file) {
+            return;
+        }
+        if (precision == StoragePrecision::Float32) {
+            copyMappedRows<float>();
+        } else {
+            copyMappedRows<double>();
+        }
+        releaseMapping();
+    }
+    
+    // Convert the stored rows from From to To
+    template <typename From, typename To>
+    void convertRows() {
+        ChunkedColumn<From> x_old = move(xStorage<From>());
+        ChunkedColumn<From> y_old = move(yStorage<From>());
+        xStorage<To>().clear();
+        yStorage<To>().clear();
+        reserveRows<To>(x_old.size());
+        forEachRowSpan(x_old.view(), y_old.view(), 0, x_old.size(), [&](const From* x, const From* y, size_t n) {
+            xStorage<To>().append(x, n);
+            yStorage<To>().append(y, n);
+        });
+    }
+    
+    template <typename T>
+    void appendRows(const double* x, const double* y, size_t n) {
+        xStorage<T>().append(x, n);
+        yStorage<T>().append(y, n);
+    }
+    
+    template <typename T>
+    void parseMappedRows(const char* body, const char* end) {
+        reserveRows<T>(estimateCSVRows(body, end));
+        
+        vector<pair<const char*, const char*>> invalid_lines;
+        parseCSVRange(body, end, xStorage<T>(), yStorage<T>(), invalid_lines);
+        reportInvalidCSVLines(invalid_lines);
+        pool->trim();
+    }
+    
+    template <typename T>
+    void parseMappedRowsParallel(const char* body, const char* end, unsigned num_threads) {
+        if (num_threads == 0) {
+            num_threads = max(1u, thread::hardware_concurrency());
+        }
+        // Keep chunks large enough that thread start-up is worth it
+        const size_t min_chunk_bytes = 1 << 20;
+        size_t body_bytes = end - body;
+        size_t num_chunks = max<size_t>(1, min<size_t>(num_threads, body_bytes / min_chunk_bytes));
+        
+        // Chunk i covers [boundaries[i], boundaries[i + 1])
+        vector<const char*> boundaries(num_chunks + 1, end);
+        boundaries[0] = body;
+        for (size_t i = 1; i < num_chunks; ++i) {
+            const char* split = max(body + body_bytes * i / num_chunks, boundaries[i - 1]);
+            if (split > body && *(split - 1) != '\n') {
+                split = min(findLineEnd(split, end) + 1, end);
+            }
+            boundaries[i] = split;
+        }
+        
+        // Each thread fills its own columns from the shared pool; every
+        // thread's last block may be partial, so reserve one extra per column
+        vector<ChunkedColumn<T>> chunk_x;
+        vector<ChunkedColumn<T>> chunk_y;
+        size_t blocks = 0;
+        for (size_t i = 0; i < num_chunks; ++i) {
+            size_t estimated_rows = estimateCSVRows(boundaries[i], boundaries[i + 1]);
+            chunk_x.emplace_back(pool);
+            chunk_y.emplace_back(pool);
+            blocks += chunk_x[i].reserve(estimated_rows) + chunk_y[i].reserve(estimated_rows);
+        }
+        pool->reserve(blocks);
+        vector<vector<pair<const char*, const char*>>> chunk_invalid(num_chunks);
+        
+        auto parse_chunk = [&](size_t i) {
+            parseCSVRange(boundaries[i], boundaries[i + 1], chunk_x[i], chunk_y[i], chunk_invalid[i]);
+        };
+        
+        vector<thread> workers;
+        for (size_t i = 1; i < num_chunks; ++i) {
+            workers.emplace_back(parse_chunk, i);
+        }
+        parse_chunk(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        
+        // Splicing reuses each copied block for the next rows, so the file
+        // order is restored without holding the data twice
+        ChunkedColumn<T>& xs = xStorage<T>();
+        ChunkedColumn<T>& ys = yStorage<T>();
+        for (size_t i = 0; i < num_chunks; ++i) {
+            xs.splice(chunk_x[i]);
+            ys.splice(chunk_y[i]);
+            reportInvalidCSVLines(chunk_invalid[i]);
+        }
+        pool->trim();
+    }
+    
+    template <typename T>
+    void writeColumns(ofstream& file) const {
+        BasicColumnView<T> x_vals = columnX<T>();
+        BasicColumnView<T> y_vals = columnY<T>();
+        auto write_span = [&](const T* values, size_t n) {
+            file.write(reinterpret_cast<const char*>(values), n * sizeof(T));
+        };
+        x_vals.forEachSpan(0, x_vals.size(), write_span);
+        y_vals.forEachSpan(0, y_vals.size(), write_span);
+    }
+
+public:
+    Dataset() : pool(make_shared<ChunkPool>()), x_values(pool), y_values(pool), x_floats(pool), y_floats(pool),
+                precision(StoragePrecision::Double), x_label("X"), y_label("Y"),
+                load_bytes(0), load_seconds(0), mapped_x(nullptr), mapped_y(nullptr), mapped_rows(0) {}
+    
+    // Storage for loaded and added values; existing values are converted
+    void setStoragePrecision(StoragePrecision new_precision) {
+        if (new_precision == precision) {
+            return;
+        }
+        detachMapping();
+        if (new_precision == StoragePrecision::Float32) {
+            convertRows<double, float>();
+        } else {
+            convertRows<float, double>();
+        }
+        pool->trim();
+        precision = new_precision;
+    }
+    StoragePrecision getStoragePrecision() const { return precision; }
+    
+    void loadFromCSV(const string& filename) {
+        LR_METRICS_PHASE("load_csv_stream");
+        auto start_time = chrono::steady_clock::now();
+        clearColumns();
+        
+        ifstream file(filename);
+        if (!file.is_open()) {
+            throw runtime_error("Cannot open file: " + filename);
+        }
+        
+        // Size the columns from the file length and the first lines
+        uint64_t file_bytes = 0;
+        {
+            vector<char> sample(64 * 1024);
+            file.read(sample.data(), sample.size());
+            size_t sampled = static_cast<size_t>(file.gcount());
+            file.clear();
+            file.seekg(0, ios::end);
+            file_bytes = static_cast<uint64_t>(file.tellg());
+            file.seekg(0);
+            size_t estimated_rows = estimateCSVRows(sample.data(), sample.data() + sampled, file_bytes);
+            if (precision == StoragePrecision::Float32) {
+                reserveRows<float>(estimated_rows);
+            } else {
+                reserveRows<double>(estimated_rows);
+            }
+        }
+        
+        string line;
+        // Skip header if exists
+        if (getline(file, line)) {
+            istringstream header_stream(line);
+            string x_header, y_header;
+            if (getline(header_stream, x_header, ',') && 
+                getline(header_stream, y_header, ',')) {
+                x_label = x_header;
+                y_label = y_header;
+            } else {
+                // Reset to read first line as data
+                file.clear();
+                file.seekg(0);
+            }
+        }
+        
+        while (getline(file, line)) {
+            istringstream ss(line);
+            string x_str, y_str;
+            
+            if (getline(ss, x_str, ',') && getline(ss, y_str, ',')) {
+                try {
+                    double x = stod(x_str);
+                    double y = stod(y_str);
+                    addDataPoint(x, y);
+                } catch (const exception& e) {
+                    cerr << "Warning: Invalid data in line: " << line << endl;
+                    LR_METRICS_COUNT("bad_rows", 1);
+                }
+            }
+        }
+        
+        pool->trim();
+        
+        if (getSize() == 0) {
+            throw runtime_error("No valid data found in file: " + filename);
+        }
+        
+        load_bytes = file_bytes;
+        load_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        LR_METRICS_COUNT("rows_parsed", getSize());
+        LR_METRICS_COUNT("bytes_read", load_bytes);
+    }
+    
+    // Memory-mapped loader: same rows and labels as loadFromCSV, parsed in
+    // place with from_chars so no strings are built per row
+    void loadFromCSVMapped(const string& filename) {
+        LR_METRICS_PHASE("load_csv_mapped");
+        auto start_time = chrono::steady_clock::now();
+        MappedFile file(filename);
+        clearColumns();
+        
+        const char* body = skipCSVHeader(file.begin(), file.end(), x_label, y_label);
+        if (precision == StoragePrecision::Float32) {
+            parseMappedRows<float>(body, file.end());
+        } else {
+            parseMappedRows<double>(body, file.end());
+        }
+        
+        if (getSize() == 0) {
+            throw runtime_error("No valid data found in file: " + filename);
+        }
+        
+        load_bytes = file.getSize();
+        load_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        LR_METRICS_COUNT("rows_parsed", getSize());
+        LR_METRICS_COUNT("bytes_read", load_bytes);
+    }
+    
+    // Parallel loader: splits the mapped file into byte ranges aligned to
+    // line boundaries, parses each on its own thread and concatenates the
+    // results in file order. num_threads = 0 uses every hardware thread.
+    void loadFromCSVParallel(const string& filename, unsigned num_threads = 0) {
+        LR_METRICS_PHASE("load_csv_parallel");
+        auto start_time = chrono::steady_clock::now();
+        MappedFile file(filename);
+        clearColumns();
+        
+        const char* body = skipCSVHeader(file.begin(), file.end(), x_label, y_label);
+        if (precision == StoragePrecision::Float32) {
+            parseMappedRowsParallel<float>(body, file.end(), num_threads);
+        } else {
+            parseMappedRowsParallel<double>(body, file.end(), num_threads);
+        }
+        
+        if (getSize() == 0) {
+            throw runtime_error("No valid data found in file: " + filename);
+        }
+        
+        load_bytes = file.getSize();
+        load_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        LR_METRICS_COUNT("rows_parsed", getSize());
+        LR_METRICS_COUNT("bytes_read", load_bytes);
+    }
+    
+    // Map a .lrbin file written by saveBinary; the columns are used in place
+    // without copying
+    void loadFromBinary(const string& filename) {
+        LR_METRICS_PHASE("load_binary");
+        auto start_time = chrono::steady_clock::now();
+        auto file = make_shared<MappedFile>(filename);
+        
+        BinaryDatasetHeader header;
+        if (file->getSize() < sizeof(header)) {
+            throw runtime_error("Not a binary dataset: " + filename);
+        }
+        memcpy(&header, file->begin(), sizeof(header));
+        
+        if (memcmp(header.magic, BINARY_DATASET_MAGIC, sizeof(header.magic)) != 0) {
+            throw runtime_error("Not a binary dataset: " + filename);
+        }
+        if (header.version != BINARY_DATASET_VERSION ||
+            (header.value_size != sizeof(double) && header.value_size != sizeof(float))) {
+            throw runtime_error("Unsupported binary dataset version in: " + filename);
+        }
+        
+        // Bound row_count by the bytes after data_offset before multiplying,
+        // so a corrupt header cannot wrap the size check
+        uint64_t labels_end = sizeof(header) + uint64_t(header.x_label_length) + header.y_label_length;
+        if (labels_end > header.data_offset || header.data_offset % alignof(double) != 0 ||
+            header.data_offset > file->getSize() ||
+            header.row_count > (file->getSize() - header.data_offset) / (2 * header.value_size)) {
+            throw runtime_error("Truncated binary dataset: " + filename);
+        }
+        if (header.row_count == 0) {
+            throw runtime_error("No valid data found in file: " + filename);
+        }
+        
+        const char* labels = file->begin() + sizeof(header);
+        
+        // The file decides the precision; setStoragePrecision() converts
+        clearColumns();
+        x_label.assign(labels, header.x_label_length);
+        y_label.assign(labels + header.x_label_length, header.y_label_length);
+        
+        precision = header.value_size == sizeof(float) ? StoragePrecision::Float32 : StoragePrecision::Double;
+        mapped_x = file->begin() + header.data_offset;
+        mapped_y = file->begin() + header.data_offset + header.row_count * header.value_size;
+        mapped_rows = header.row_count;
+        mapped_file = file;
+        
+        load_bytes = file->getSize();
+        load_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        LR_METRICS_COUNT("rows_mapped", mapped_rows);
+        LR_METRICS_COUNT("bytes_read", load_bytes);
+    }
+    
+    // Write the dataset as .lrbin; written to a temporary file and renamed
+    // so a reader never sees a half-written cache
+    void saveBinary(const string& filename) const {
+        BinaryDatasetHeader header = makeBinaryDatasetHeader(getSize(), x_label, y_label,
+            precision == StoragePrecision::Float32 ? sizeof(float) : sizeof(double));
+        const uint64_t alignment = BINARY_DATASET_ALIGNMENT;
+        uint64_t labels_end = sizeof(header) + x_label.size() + y_label.size();
+        
+        string temp_filename = filename + ".tmp";
+        {
+            ofstream file(temp_filename, ios::binary | ios::trunc);
+            if (!file.is_open()) {
+                throw runtime_error("Cannot create file: " + temp_filename);
+            }
+            
+            const char padding[alignment] = {};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(x_label.data(), x_label.size());
+            file.write(y_label.data(), y_label.size());
+            file.write(padding, header.data_offset - labels_end);
+            if (precision == StoragePrecision::Float32) {
+                writeColumns<float>(file);
+            } else {
+                writeColumns<double>(file);
+            }
+            
+            if (!file) {
+                throw runtime_error("Failed writing file: " + temp_filename);
+            }
+        }
+        filesystem::rename(temp_filename, filename);
+    }
+    
+    void addDataPoint(double x, double y) {
+        addDataPoints(&x, &y, 1);
+    }
+    
+    void addDataPoints(const double* x, const double* y, size_t n) {
+        detachMapping();
+        if (precision == StoragePrecision::Float32) {
+            appendRows<float>(x, y, n);
+        } else {
+            appendRows<double>(x, y, n);
+        }
+    }
+    
+    // Typed column access; T must match the storage precision. Views stay
+    // valid until the dataset is next loaded or modified.
+    template <typename T>
+    BasicColumnView<T> columnX() const {
+        if (mapped_file) {
+            return BasicColumnView<T>(static_cast<const T*>(mapped_x), mapped_rows);
+        }
+        return xStorage<T>().view();
+    }
+    template <typename T>
+    BasicColumnView<T> columnY() const {
+        if (mapped_file) {
+            return BasicColumnView<T>(static_cast<const T*>(mapped_y), mapped_rows);
+        }
+        return yStorage<T>().view();
+    }
+    
+    // Double columns; only valid with StoragePrecision::Double. Code that
+    // must handle both precisions uses visitColumns().
+    ColumnView getXValues() const {
+        requirePrecision(StoragePrecision::Double);
+        return columnX<double>();
+    }
+    ColumnView getYValues() const {
+        requirePrecision(StoragePrecision::Double);
+        return columnY<double>();
+    }
+    FloatColumnView getXFloats() const {
+        requirePrecision(StoragePrecision::Float32);
+        return columnX<float>();
+    }
+    FloatColumnView getYFloats() const {
+        requirePrecision(StoragePrecision::Float32);
+        return columnY<float>();
+    }
+    
+    void requirePrecision(StoragePrecision expected) const {
+        if (precision != expected) {
+            throw logic_error("Dataset stores " + storagePrecisionName(precision) + " values, not " +
+                              storagePrecisionName(expected));
+        }
+    }
+    
+    // Call visitor(x_column, y_column) with the columns in their stored
+    // type (ColumnView or FloatColumnView), so one generic lambda or
+    // template serves both precisions without copying
+    template <typename Visitor>
+    auto visitColumns(Visitor&& visitor) const {
+        if (precision == StoragePrecision::Float32) {
+            return visitor(columnX<float>(), columnY<float>());
+        }
+        return visitor(columnX<double>(), columnY<double>());
+    }
+    
+    // Call block(x, y, rows) on rows [first_row, size) as double arrays:
+    // the stored spans for Double storage, converted 4096-row blocks for
+    // Float32. For consumers that only accept double input.
+    template <typename BlockHandler>
+    void forEachDoubleBlock(size_t first_row, BlockHandler&& block) const {
+        if (precision == StoragePrecision::Double) {
+            ColumnView x_vals = columnX<double>();
+            ColumnView y_vals = columnY<double>();
+            forEachRowSpan(x_vals, y_vals, min(first_row, x_vals.size()), x_vals.size(), block);
+            return;
+        }
+        
+        const size_t block_rows = 4096;
+        double bx[block_rows];
+        double by[block_rows];
+        FloatColumnView x_vals = columnX<float>();
+        FloatColumnView y_vals = columnY<float>();
+        forEachRowSpan(x_vals, y_vals, min(first_row, x_vals.size()), x_vals.size(),
+                       [&](const float* x, const float* y, size_t n) {
+            for (size_t start = 0; start < n; start += block_rows) {
+                size_t rows = min(block_rows, n - start);
+                copy(x + start, x + start + rows, bx);
+                copy(y + start, y + start + rows, by);
+                block(bx, by, rows);
+            }
+        });
+    }
+    
+    size_t getSize() const {
+        if (mapped_file) {
+            return mapped_rows;
+        }
+        return precision == StoragePrecision::Float32 ? x_floats.size() : x_values.size();
+    }
+    
+    // Bytes held by the x and y values
+    size_t getColumnBytes() const {
+        return getSize() * 2 * (precision == StoragePrecision::Float32 ? sizeof(float) : sizeof(double));
+    }
+    
+    // Bytes of chunk memory allocated, including the unused tail of each
+    // column's last chunk; 0 while the columns are mapped from a file
+    size_t getAllocatedBytes() const { return pool->getAllocatedBytes(); }
+    bool isMapped() const { return mapped_file != nullptr; }
+    void setLabels(const string& x_label, const string& y_label) {
+        this->x_label = x_label;
+        this->y_label = y_label;
+    }
+    string getXLabel() const { return x_label; }
+    string getYLabel() const { return y_label; }
+    size_t getLoadBytes() const { return load_bytes; }
+    double getLoadSeconds() const { return load_seconds; }
+    
+    void displaySummary() const {
+        cout << "\n*** Dataset Summary ***" << endl;
+        cout << "Size: " << getSize() << " data points" << endl;
+        cout << "X Label: " << x_label << endl;
+        cout << "Y Label: " << y_label << endl;
+        cout << "Storage: " << storagePrecisionName(precision) << " ("
+             << getColumnBytes() / (1024.0 * 1024.0) << " MB)" << endl;
+        
+        visitColumns([](auto x_vals, auto y_vals) {
+            if (!x_vals.empty()) {
+                pair<double, double> x_range = columnRange(x_vals);
+                pair<double, double> y_range = columnRange(y_vals);
+                
+                cout << "X Range: [" << x_range.first << ", " << x_range.second << "]" << endl;
+                cout << "Y Range: [" << y_range.first << ", " << y_range.second << "]" << endl;
+            }
+        });
+        
+        if (load_bytes > 0 && load_seconds > 0) {
+            cout << "Load Throughput: " << fixed << setprecision(1)
+                 << (load_bytes / load_seconds) / (1024.0 * 1024.0) << " MB/s ("
+                 << load_bytes << " bytes in " << setprecision(4) << load_seconds << " s)" << endl;
+            cout << defaultfloat << setprecision(6);
+        }
+    }
+};
+
+// True when filename's .lrbin cache exists and is newer than filename
+bool isBinaryCacheFresh(const string& filename) {
+    error_code ec;
+    string cache = binaryCachePath(filename);
+    if (cache == filename || !filesystem::exists(cache, ec)) {
+        return false;
+    }
+    
+    auto cache_time = filesystem::last_write_time(cache, ec);
+    if (ec) {
+        return false;
+    }
+    auto source_time = filesystem::last_write_time(filename, ec);
+    return !ec && cache_time > source_time;
+}
+
+// Convert a CSV file to its .lrbin cache once; later loadData calls map it
+void convertCSVToBinary(const string& csv_filename, const string& binary_filename) {
+    Dataset dataset;
+    dataset.loadFromCSVParallel(csv_filename);
+    dataset.saveBinary(binary_filename);
+}
+
+// Gradient Kernels - one fused pass over the data returns the sums needed for
+// both MSE gradients (and the loss) at the given slope and intercept, where
+// e = slope * x + intercept - y. The vector kernels sum in a different order
+// than the scalar loop, so results differ from it by rounding only
+// (relative difference around n * 1e-16 per pass).
+struct GradientSums {
+    double error_x;        // sum of e * x
+    double error;          // sum of e
+    double squared_error;  // sum of e * e
+};
+
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+// Kernels are templates on the stored element type (double or float);
+// float inputs are widened on load and everything is accumulated in double.
+template <typename T>
+GradientSums gradientSumsScalar(const T* x, const T* y, size_t n,
+                                double slope, double intercept) {
+    GradientSums sums = {0.0, 0.0, 0.0};
+    for (size_t i = 0; i < n; ++i) {
+        double xi = x[i];
+        double error = slope * xi + intercept - y[i];
+        sums.error_x += error * xi;
+        sums.error += error;
+        sums.squared_error += error * error;
+    }
+    return sums;
+}
+
+#ifdef LR_X86_DISPATCH
+// Load 4 (AVX2) or 8 (AVX-512) values as doubles, widening floats
+__attribute__((target("avx2,fma"), always_inline))
+inline __m256d loadAVX2(const double* p) { return _mm256_loadu_pd(p); }
+__attribute__((target("avx2,fma"), always_inline))
+inline __m256d loadAVX2(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+__attribute__((target("avx512f"), always_inline))
+inline __m512d loadAVX512(const double* p) { return _mm512_loadu_pd(p); }
+__attribute__((target("avx512f"), always_inline))
+inline __m512d loadAVX512(const float* p) {
+    // Zero-masked form of _mm512_cvtps_pd, which GCC flags as reading an uninitialized source
+    return _mm512_maskz_cvtps_pd(0xFF, _mm256_loadu_ps(p));
+}
+
+template <typename T>
+__attribute__((target("avx2,fma")))
+GradientSums gradientSumsAVX2(const T* x, const T* y, size_t n,
+                              double slope, double intercept) {
+    const __m256d vslope = _mm256_set1_pd(slope);
+    const __m256d vintercept = _mm256_set1_pd(intercept);
+    // Two independent accumulator sets hide the FMA latency
+    __m256d ex0 = _mm256_setzero_pd(), ex1 = _mm256_setzero_pd();
+    __m256d e0 = _mm256_setzero_pd(), e1 = _mm256_setzero_pd();
+    __m256d ee0 = _mm256_setzero_pd(), ee1 = _mm256_setzero_pd();
+    
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d xa = loadAVX2(x + i);
+        __m256d xb = loadAVX2(x + i + 4);
+        __m256d ea = _mm256_sub_pd(_mm256_fmadd_pd(vslope, xa, vintercept), loadAVX2(y + i));
+        __m256d eb = _mm256_sub_pd(_mm256_fmadd_pd(vslope, xb, vintercept), loadAVX2(y + i + 4));
+        ex0 = _mm256_fmadd_pd(ea, xa, ex0);
+        ex1 = _mm256_fmadd_pd(eb, xb, ex1);
+        e0 = _mm256_add_pd(e0, ea);
+        e1 = _mm256_add_pd(e1, eb);
+        ee0 = _mm256_fmadd_pd(ea, ea, ee0);
+        ee1 = _mm256_fmadd_pd(eb, eb, ee1);
+    }
+    
+    alignas(32) double lanes[3][4];
+    _mm256_store_pd(lanes[0], _mm256_add_pd(ex0, ex1));
+    _mm256_store_pd(lanes[1], _mm256_add_pd(e0, e1));
+    _mm256_store_pd(lanes[2], _mm256_add_pd(ee0, ee1));
+    
+    GradientSums sums = gradientSumsScalar(x + i, y + i, n - i, slope, intercept);
+    for (int lane = 0; lane < 4; ++lane) {
+        sums.error_x += lanes[0][lane];
+        sums.error += lanes[1][lane];
+        sums.squared_error += lanes[2][lane];
+    }
+    return sums;
+}
+
+template <typename T>
+__attribute__((target("avx512f")))
+GradientSums gradientSumsAVX512(const T* x, const T* y, size_t n,
+                                double slope, double intercept) {
+    const __m512d vslope = _mm512_set1_pd(slope);
+    const __m512d vintercept = _mm512_set1_pd(intercept);
+    __m512d ex0 = _mm512_setzero_pd(), ex1 = _mm512_setzero_pd();
+    __m512d e0 = _mm512_setzero_pd(), e1 = _mm512_setzero_pd();
+    __m512d ee0 = _mm512_setzero_pd(), ee1 = _mm512_setzero_pd();
+    
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d xa = loadAVX512(x + i);
+        __m512d xb = loadAVX512(x + i + 8);
+        __m512d ea = _mm512_sub_pd(_mm512_fmadd_pd(vslope, xa, vintercept), loadAVX512(y + i));
+        __m512d eb = _mm512_sub_pd(_mm512_fmadd_pd(vslope, xb, vintercept), loadAVX512(y + i + 8));
+        ex0 = _mm512_fmadd_pd(ea, xa, ex0);
+        ex1 = _mm512_fmadd_pd(eb, xb, ex1);
+        e0 = _mm512_add_pd(e0, ea);
+        e1 = _mm512_add_pd(e1, eb);
+        ee0 = _mm512_fmadd_pd(ea, ea, ee0);
+        ee1 = _mm512_fmadd_pd(eb, eb, ee1);
+    }
+    
+    alignas(64) double lanes[3][8];
+    _mm512_store_pd(lanes[0], _mm512_add_pd(ex0, ex1));
+    _mm512_store_pd(lanes[1], _mm512_add_pd(e0, e1));
+    _mm512_store_pd(lanes[2], _mm512_add_pd(ee0, ee1));
+    
+    GradientSums sums = gradientSumsScalar(x + i, y + i, n - i, slope, intercept);
+    for (int lane = 0; lane < 8; ++lane) {
+        sums.error_x += lanes[0][lane];
+        sums.error += lanes[1][lane];
+        sums.squared_error += lanes[2][lane];
+    }
+    return sums;
+}
+#endif
+
+// Evaluation Kernels - one pass accumulates everything the fit metrics need.
+// Sums use Kahan compensation (per SIMD lane, then across lanes) so the
+// metrics stay accurate on very large inputs. y is shifted by y_shift (any
+// value close to the mean, e.g. the first y) before squaring, which keeps
+// the total sum of squares from cancelling.
+struct ErrorSums {
+    double squared_error;      // sum of e^2, e = y - prediction
+    double absolute_error;     // sum of |e|
+    double max_absolute_error; // max |e|
+    double shifted_y;          // sum of (y - y_shift)
+    double shifted_y_squared;  // sum of (y - y_shift)^2
+};
+
+struct KahanSum {
+    double sum = 0.0;
+    double compensation = 0.0;
+    
+    void add(double value) {
+        double corrected = value - compensation;
+        double total = sum + corrected;
+        compensation = (total - sum) - corrected;
+        sum = total;
+    }
+};
+
+template <typename T>
+ErrorSums errorSumsScalar(const T* x, const T* y, size_t n,
+                          double slope, double intercept, double y_shift) {
+    KahanSum squared, absolute, shifted, shifted_squared;
+    double max_error = 0.0;
+    
+    for (size_t i = 0; i < n; ++i) {
+        double yi = y[i];
+        double error = yi - (slope * x[i] + intercept);
+        double dy = yi - y_shift;
+        squared.add(error * error);
+        absolute.add(abs(error));
+        shifted.add(dy);
+        shifted_squared.add(dy * dy);
+        max_error = max(max_error, abs(error));
+    }
+    return ErrorSums{squared.sum, absolute.sum, max_error, shifted.sum, shifted_squared.sum};
+}
+
+#ifdef LR_X86_DISPATCH
+__attribute__((target("avx2,fma"), always_inline))
+inline void kahanAddAVX2(__m256d& sum, __m256d& compensation, __m256d value) {
+    __m256d corrected = _mm256_sub_pd(value, compensation);
+    __m256d total = _mm256_add_pd(sum, corrected);
+    compensation = _mm256_sub_pd(_mm256_sub_pd(total, sum), corrected);
+    sum = total;
+}
+
+// Memory bound, so AVX-512 CPUs use this kernel as well
+template <typename T>
+__attribute__((target("avx2,fma")))
+ErrorSums errorSumsAVX2(const T* x, const T* y, size_t n,
+                        double slope, double intercept, double y_shift) {
+    const __m256d vslope = _mm256_set1_pd(slope);
+    const __m256d vintercept = _mm256_set1_pd(intercept);
+    const __m256d vshift = _mm256_set1_pd(y_shift);
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    __m256d squared = _mm256_setzero_pd(), squared_c = _mm256_setzero_pd();
+    __m256d absolute = _mm256_setzero_pd(), absolute_c = _mm256_setzero_pd();
+    __m256d shifted = _mm256_setzero_pd(), shifted_c = _mm256_setzero_pd();
+    __m256d shifted_sq = _mm256_setzero_pd(), shifted_sq_c = _mm256_setzero_pd();
+    __m256d max_error = _mm256_setzero_pd();
+    
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d vy = loadAVX2(y + i);
+        __m256d error = _mm256_sub_pd(vy, _mm256_fmadd_pd(vslope, loadAVX2(x + i), vintercept));
+        __m256d abs_error = _mm256_andnot_pd(sign_mask, error);
+        __m256d dy = _mm256_sub_pd(vy, vshift);
+        
+        kahanAddAVX2(squared, squared_c, _mm256_mul_pd(error, error));
+        kahanAddAVX2(absolute, absolute_c, abs_error);
+        kahanAddAVX2(shifted, shifted_c, dy);
+        kahanAddAVX2(shifted_sq, shifted_sq_c, _mm256_mul_pd(dy, dy));
+        max_error = _mm256_max_pd(max_error, abs_error);
+    }
+    
+    alignas(32) double lanes[9][4];
+    _mm256_store_pd(lanes[0], squared);
+    _mm256_store_pd(lanes[1], squared_c);
+    _mm256_store_pd(lanes[2], absolute);
+    _mm256_store_pd(lanes[3], absolute_c);
+    _mm256_store_pd(lanes[4], shifted);
+    _mm256_store_pd(lanes[5], shifted_c);
+    _mm256_store_pd(lanes[6], shifted_sq);
+    _mm256_store_pd(lanes[7], shifted_sq_c);
+    _mm256_store_pd(lanes[8], max_error);
+    
+    ErrorSums tail = errorSumsScalar(x + i, y + i, n - i, slope, intercept, y_shift);
+    KahanSum total[4];
+    total[0].add(tail.squared_error);
+    total[1].add(tail.absolute_error);
+    total[2].add(tail.shifted_y);
+    total[3].add(tail.shifted_y_squared);
+    double max_abs = tail.max_absolute_error;
+    
+    for (int lane = 0; lane < 4; ++lane) {
+        for (int k = 0; k < 4; ++k) {
+            total[k].add(lanes[2 * k][lane]);
+            total[k].add(-lanes[2 * k + 1][lane]);
+        }
+        max_abs = max(max_abs, lanes[8][lane]);
+    }
+    return ErrorSums{total[0].sum, total[1].sum, max_abs, total[2].sum, total[3].sum};
+}
+#endif
+
+// Widest instruction set supported by this CPU (checked once)
+SimdLevel detectSimdLevel() {
+#ifdef LR_X86_DISPATCH
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+string simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "AVX-512";
+        case SimdLevel::AVX2: return "AVX2";
+        default: return "Scalar";
+    }
+}
+
+template <typename T>
+using GradientKernelFor = GradientSums (*)(const T*, const T*, size_t, double, double);
+typedef GradientKernelFor<double> GradientKernel;
+
+// Dot Product Kernels - sum of a[i] * b[i]
+double dotProductScalar(const double* a, const double* b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#ifdef LR_X86_DISPATCH
+__attribute__((target("avx2,fma")))
+double dotProductAVX2(const double* a, const double* b, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+        acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+    }
+    
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotProductScalar(a + i, b + i, n - i);
+}
+#endif
+
+typedef double (*DotKernel)(const double*, const double*, size_t);
+
+DotKernel selectDotKernel(SimdLevel requested) {
+#ifdef LR_X86_DISPATCH
+    if (min(requested, detectSimdLevel()) >= SimdLevel::AVX2) return dotProductAVX2;
+#endif
+    (void)requested;
+    return dotProductScalar;
+}
+
+template <typename T>
+using ErrorKernelFor = ErrorSums (*)(const T*, const T*, size_t, double, double, double);
+typedef ErrorKernelFor<double> ErrorKernel;
+
+template <typename T = double>
+ErrorKernelFor<T> selectErrorKernel(SimdLevel requested) {
+#ifdef LR_X86_DISPATCH
+    if (min(requested, detectSimdLevel()) >= SimdLevel::AVX2) return errorSumsAVX2<T>;
+#endif
+    (void)requested;
+    return errorSumsScalar<T>;
+}
+
+// Pick the kernel for the requested level, falling back to what the CPU has
+template <typename T = double>
+GradientKernelFor<T> selectGradientKernel(SimdLevel requested) {
+    SimdLevel level = min(requested, detectSimdLevel());
+#ifdef LR_X86_DISPATCH
+    if (level == SimdLevel::AVX512) return gradientSumsAVX512<T>;
+    if (level == SimdLevel::AVX2) return gradientSumsAVX2<T>;
+#endif
+    (void)level;
+    return gradientSumsScalar<T>;
+}
+
+// Prediction Kernels - out[i] = slope * x[i] + intercept over whole arrays
+template <typename T>
+void predictBatchScalar(const T* x, double* out, size_t n, double slope, double intercept) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = slope * x[i] + intercept;
+    }
+}
+
+#ifdef LR_X86_DISPATCH
+template <typename T>
+__attribute__((target("avx2,fma")))
+void predictBatchAVX2(const T* x, double* out, size_t n, double slope, double intercept) {
+    const __m256d vslope = _mm256_set1_pd(slope);
+    const __m256d vintercept = _mm256_set1_pd(intercept);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_pd(out + i, _mm256_fmadd_pd(vslope, loadAVX2(x + i), vintercept));
+        _mm256_storeu_pd(out + i + 4, _mm256_fmadd_pd(vslope, loadAVX2(x + i + 4), vintercept));
+    }
+    predictBatchScalar(x + i, out + i, n - i, slope, intercept);
+}
+
+template <typename T>
+__attribute__((target("avx512f")))
+void predictBatchAVX512(const T* x, double* out, size_t n, double slope, double intercept) {
+    const __m512d vslope = _mm512_set1_pd(slope);
+    const __m512d vintercept = _mm512_set1_pd(intercept);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_pd(out + i, _mm512_fmadd_pd(vslope, loadAVX512(x + i), vintercept));
+        _mm512_storeu_pd(out + i + 8, _mm512_fmadd_pd(vslope, loadAVX512(x + i + 8), vintercept));
+    }
+    predictBatchScalar(x + i, out + i, n - i, slope, intercept);
+}
+#endif
+
+template <typename T>
+using PredictKernelFor = void (*)(const T*, double*, size_t, double, double);
+typedef PredictKernelFor<double> PredictKernel;
+
+template <typename T = double>
+PredictKernelFor<T> selectPredictKernel(SimdLevel requested) {
+    SimdLevel level = min(requested, detectSimdLevel());
+#ifdef LR_X86_DISPATCH
+    if (level == SimdLevel::AVX512) return predictBatchAVX512<T>;
+    if (level == SimdLevel::AVX2) return predictBatchAVX2<T>;
+#endif
+    (void)level;
+    return predictBatchScalar<T>;
+}
+
+// Kernel sums over rows [begin, end) of chunked columns: one kernel call per
+// contiguous span, added up in row order
+template <typename T>
+GradientSums gradientSumsRange(GradientKernelFor<T> kernel, const BasicColumnView<T>& x_vals,
+                               const BasicColumnView<T>& y_vals, size_t begin, size_t end,
+                               double slope, double intercept) {
+    GradientSums sums = {0.0, 0.0, 0.0};
+    forEachRowSpan(x_vals, y_vals, begin, end, [&](const T* x, const T* y, size_t n) {
+        GradientSums span = kernel(x, y, n, slope, intercept);
+        sums.error_x += span.error_x;
+        sums.error += span.error;
+        sums.squared_error += span.squared_error;
+    });
+    return sums;
+}
+
+// Span results are combined with Kahan compensation as well
+template <typename T>
+ErrorSums errorSumsRange(ErrorKernelFor<T> kernel, const BasicColumnView<T>& x_vals,
+                         const BasicColumnView<T>& y_vals, double slope, double intercept, double y_shift) {
+    KahanSum total[4];
+    double max_abs = 0.0;
+    forEachRowSpan(x_vals, y_vals, 0, x_vals.size(), [&](const T* x, const T* y, size_t n) {
+        ErrorSums span = kernel(x, y, n, slope, intercept, y_shift);
+        total[0].add(span.squared_error);
+        total[1].add(span.absolute_error);
+        total[2].add(span.shifted_y);
+        total[3].add(span.shifted_y_squared);
+        max_abs = max(max_abs, span.max_absolute_error);
+    });
+    return ErrorSums{total[0].sum, total[1].sum, max_abs, total[2].sum, total[3].sum};
+}
+
+// ThreadPool Class - a fixed set of workers that all run the same task and
+// return together. The calling thread acts as worker 0, so a pool of size 1
+// starts no threads. Built once and reused, e.g. for every training iteration.
+class ThreadPool {
+private:
+    vector<thread> workers;
+    mutex pool_mutex;
+    condition_variable work_ready;
+    condition_variable work_done;
+    const function<void(size_t)>* current_task;
+    size_t generation;
+    size_t pending;
+    bool stopping;
+    
+    void workerLoop(size_t index) {
+        size_t seen_generation = 0;
+        unique_lock<mutex> lock(pool_mutex);
+        
+        while (true) {
+            work_ready.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+            const function<void(size_t)>* task = current_task;
+            
+            lock.unlock();
+            (*task)(index);
+            lock.lock();
+            
+            if (--pending == 0) {
+                work_done.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t num_threads)
+        : current_task(nullptr), generation(0), pending(0), stopping(false) {
+        for (size_t i = 1; i < num_threads; ++i) {
+            workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            stopping = true;
+        }
+        work_ready.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    size_t size() const { return workers.size() + 1; }
+    
+    // Run task(worker_index) on every worker and wait for all of them
+    void run(const function<void(size_t)>& task) {
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            current_task = &task;
+            pending = workers.size();
+            ++generation;
+        }
+        work_ready.notify_all();
+        
+        task(0);
+        
+        unique_lock<mutex> lock(pool_mutex);
+        work_done.wait(lock, [&] { return pending == 0; });
+    }
+};
+
+// Resolve a requested thread count: 0 means one per hardware thread
+unsigned resolveThreadCount(unsigned requested) {
+    return requested == 0 ? max(1u, thread::hardware_concurrency()) : requested;
+}
+
+// WorkStealingScheduler - runs independent tasks of very different cost on a
+// ThreadPool. Tasks are dealt round-robin, in the order given, into one deque
+// per worker. A worker takes from the front of its own deque and, once it is
+// empty, steals from the back of another worker's deque. Giving the tasks
+// largest first means big jobs start early and idle workers pick off the
+// small ones queued behind them.
+class WorkStealingScheduler {
+private:
+    struct WorkerQueue {
+        mutex queue_mutex;
+        deque<size_t> tasks;
+    };
+    
+    ThreadPool& pool;
+    vector<unique_ptr<WorkerQueue>> queues;
+    
+    bool popOwn(size_t worker, size_t& task) {
+        WorkerQueue& queue = *queues[worker];
+        lock_guard<mutex> lock(queue.queue_mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+    
+    bool steal(size_t thief, size_t& task) {
+        for (size_t offset = 1; offset < queues.size(); ++offset) {
+            WorkerQueue& victim = *queues[(thief + offset) % queues.size()];
+            lock_guard<mutex> lock(victim.queue_mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    explicit WorkStealingScheduler(ThreadPool& pool) : pool(pool) {
+        for (size_t i = 0; i < pool.size(); ++i) {
+            queues.push_back(make_unique<WorkerQueue>());
+        }
+    }
+    
+    // Run body(task) for every task id in `order`; returns when all are done.
+    // body must not throw.
+    void run(const vector<size_t>& order, const function<void(size_t)>& body) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            queues[i % queues.size()]->tasks.push_back(order[i]);
+        }
+        
+        pool.run([&](size_t worker) {
+            size_t task;
+            while (popOwn(worker, task) || steal(worker, task)) {
+                body(task);
+            }
+        });
+    }
+};
+
+// MultiDataset Class - several feature columns and one target column.
+// Each column is stored contiguously (column-major), so a pass over one
+// feature, or a block of rows across all features, reads memory in order.
+class MultiDataset {
+private:
+    vector<vector<double>> feature_columns;
+    vector<double> target_values;
+    vector<string> feature_labels;
+    string target_label;
+    
+    // Split one line on commas into fields; returns the number of fields
+    static size_t splitFields(const char* begin, const char* end,
+                              vector<pair<const char*, const char*>>& fields) {
+        fields.clear();
+        const char* field_begin = begin;
+        for (const char* p = begin; p <= end; ++p) {
+            if (p == end || *p == ',') {
+                fields.emplace_back(field_begin, p);
+                field_begin = p + 1;
+            }
+        }
+        return fields.size();
+    }
+
+public:
+    MultiDataset() : target_label("Y") {}
+    
+    // The last column is the target, every other column a feature. The
+    // first line is a header unless all of its fields are numbers.
+    void loadFromCSV(const string& filename) {
+        MappedFile file(filename);
+        const char* cursor = file.begin();
+        const char* end = file.end();
+        vector<pair<const char*, const char*>> fields;
+        size_t num_columns = 0;
+        
+        feature_columns.clear();
+        target_values.clear();
+        feature_labels.clear();
+        
+        // Work out the column count (and labels) from the first line
+        if (cursor < end) {
+            const char* line_end = findLineEnd(cursor, end);
+            const char* content_end = trimCarriageReturn(cursor, line_end);
+            num_columns = splitFields(cursor, content_end, fields);
+            
+            bool numeric = true;
+            double value;
+            for (const auto& field : fields) {
+                numeric = numeric && parseCSVNumber(field.first, field.second, value);
+            }
+            
+            for (size_t c = 0; c + 1 < num_columns; ++c) {
+                feature_labels.push_back(numeric ? "X" + to_string(c + 1)
+                                                 : string(fields[c].first, fields[c].second));
+            }
+            target_label = numeric ? "Y" : string(fields.back().first, fields.back().second);
+            if (!numeric) {
+                cursor = min(line_end + 1, end);
+            }
+        }
+        
+        if (num_columns < 2) {
+            throw runtime_error("Need at least one feature and one target column in: " + filename);
+        }
+        
+        size_t estimated_rows = estimateCSVRows(cursor, end);
+        feature_columns.assign(num_columns - 1, vector<double>());
+        for (auto& column : feature_columns) {
+            column.reserve(estimated_rows);
+        }
+        target_values.reserve(estimated_rows);
+        vector<double> row(num_columns);
+        
+        while (cursor < end) {
+            const char* line_end = findLineEnd(cursor, end);
+            const char* content_end = trimCarriageReturn(cursor, line_end);
+            
+            if (content_end > cursor) {
+                bool valid = splitFields(cursor, content_end, fields) == num_columns;
+                for (size_t c = 0; valid && c < num_columns; ++c) {
+                    valid = parseCSVNumber(fields[c].first, fields[c].second, row[c]);
+                }
+                
+                if (valid) {
+                    for (size_t c = 0; c + 1 < num_columns; ++c) {
+                        feature_columns[c].push_back(row[c]);
+                    }
+                    target_values.push_back(row.back());
+                } else {
+                    cerr << "Warning: Invalid data in line: ";
+                    cerr.write(cursor, content_end - cursor);
+                    cerr << endl;
+                }
+            }
+            cursor = line_end + 1;
+        }
+        
+        if (target_values.empty()) {
+            throw runtime_error("No valid data found in file: " + filename);
+        }
+    }
+    
+    void addRow(const vector<double>& features, double target) {
+        if (feature_columns.empty()) {
+            feature_columns.assign(features.size(), vector<double>());
+            for (size_t c = 0; c < features.size(); ++c) {
+                feature_labels.push_back("X" + to_string(c + 1));
+            }
+        }
+        if (features.size() != feature_columns.size()) {
+            throw runtime_error("Expected " + to_string(feature_columns.size()) + " features per row");
+        }
+        for (size_t c = 0; c < features.size(); ++c) {
+            feature_columns[c].push_back(features[c]);
+        }
+        target_values.push_back(target);
+    }
+    
+    size_t getSize() const { return target_values.size(); }
+    size_t getFeatureCount() const { return feature_columns.size(); }
+    const double* getFeatureColumn(size_t feature) const { return feature_columns[feature].data(); }
+    const double* getTargets() const { return target_values.data(); }
+    const vector<string>& getFeatureLabels() const { return feature_labels; }
+    string getTargetLabel() const { return target_label; }
+    
+    void displaySummary() const {
+        cout << "\n*** Dataset Summary ***" << endl;
+        cout << "Size: " << getSize() << " data points" << endl;
+        cout << "Features: " << getFeatureCount() << endl;
+        cout << "Target Label: " << target_label << endl;
+    }
+};
+
+// RegressionMetrics - fit quality of a line on a dataset
+struct RegressionMetrics {
+    size_t count = 0;
+    double mse = 0.0;
+    double rmse = 0.0;
+    double mae = 0.0;
+    double r_squared = 0.0;
+    double max_error = 0.0;
+};
+
+RegressionMetrics metricsFromErrorSums(const ErrorSums& sums, size_t n) {
+    RegressionMetrics metrics;
+    metrics.count = n;
+    if (n == 0) {
+        return metrics;
+    }
+    
+    metrics.mse = sums.squared_error / n;
+    metrics.rmse = sqrt(metrics.mse);
+    metrics.mae = sums.absolute_error / n;
+    metrics.max_error = sums.max_absolute_error;
+    
+    double total_sum_squares = sums.shifted_y_squared - sums.shifted_y * sums.shifted_y / n;
+    if (total_sum_squares > 0) {
+        metrics.r_squared = 1.0 - sums.squared_error / total_sum_squares;
+    } else {
+        metrics.r_squared = (sums.squared_error == 0.0) ? 1.0 : 0.0;
+    }
+    return metrics;
+}
+
+// RegressionModel Base Class
+class RegressionModel {
+protected:
+    double slope;
+    double intercept;
+    double mse;
+    double r_squared;
+    
+    // Set mse and r_squared from a full evaluation pass
+    void updateMetrics(const Dataset& dataset) {
+        RegressionMetrics metrics = evaluate(dataset);
+        mse = metrics.mse;
+        r_squared = metrics.r_squared;
+    }
+
+public:
+    RegressionModel() : slope(0), intercept(0), mse(0), r_squared(0) {}
+    virtual ~RegressionModel() = default;
+    
+    virtual void train(const Dataset& dataset) = 0;
+    virtual string getMethodName() const = 0;
+    
+    // Incremental models fold new points into the fit in O(1) per point
+    // instead of needing a full train() again
+    virtual bool isIncremental() const { return false; }
+    virtual void addObservations(const double* x, const double* y, size_t n) {
+        (void)x; (void)y; (void)n;
+        throw runtime_error("This model does not support incremental updates");
+    }
+    
+    // Points the current incremental fit is based on
+    virtual size_t getObservationCount() const { return 0; }
+    
+    // False for models that keep their own bounded state, so the caller
+    // should not store every point in a Dataset
+    virtual bool needsHistory() const { return true; }
+    
+    double predict(double x) const {
+        return slope * x + intercept;
+    }
+    
+    // Predict n contiguous inputs at once with the widest SIMD kernel.
+    // Uses FMA, so results can differ from predict() in the last bit.
+    void predictBatch(const double* x, double* out, size_t n) const {
+        static const PredictKernel kernel = selectPredictKernel(detectSimdLevel());
+        kernel(x, out, n, slope, intercept);
+    }
+    
+    // Same, for float inputs (widened on load)
+    void predictBatch(const float* x, double* out, size_t n) const {
+        static const PredictKernelFor<float> kernel = selectPredictKernel<float>(detectSimdLevel());
+        kernel(x, out, n, slope, intercept);
+    }
+    
+    // MSE, RMSE, MAE, R^2 and max error in one fused, compensated pass
+    RegressionMetrics evaluate(const Dataset& dataset) const {
+        LR_METRICS_PHASE("evaluate");
+        return dataset.visitColumns([this](auto x_vals, auto y_vals) {
+            return evaluateColumns(x_vals, y_vals);
+        });
+    }
+    
+    template <typename T>
+    RegressionMetrics evaluateColumns(BasicColumnView<T> x_vals, BasicColumnView<T> y_vals) const {
+        if (x_vals.size() != y_vals.size() || x_vals.empty()) {
+            return RegressionMetrics();
+        }
+        
+        static const ErrorKernelFor<T> kernel = selectErrorKernel<T>(detectSimdLevel());
+        ErrorSums sums = errorSumsRange(kernel, x_vals, y_vals, slope, intercept, y_vals[0]);
+        return metricsFromErrorSums(sums, x_vals.size());
+    }
+    
+    // Fit quality on the points the model was fitted to: the whole dataset,
+    // except for windowed models, which override this
+    virtual RegressionMetrics evaluateFit(const Dataset& dataset) const {
+        return evaluate(dataset);
+    }
+    
+    double calculateMSE(const Dataset& dataset) const {
+        return evaluate(dataset).mse;
+    }
+    
+    double getSlope() const { return slope; }
+    double getIntercept() const { return intercept; }
+    double getMSE() const { return mse; }
+    double getRSquared() const { return r_squared; }
+    
+    string getEquation() const {
+        stringstream ss;
+        ss << fixed << setprecision(4);
+        ss << "y = " << slope << " * x + " << intercept;
+        return ss.str();
+    }
+    
+    virtual void displayResults() const {
+        cout << "\n*** Regression Results ***" << endl;
+        cout << "Equation: " << getEquation() << endl;
+        cout << "Slope: " << slope << endl;
+        cout << "Intercept: " << intercept << endl;
+        cout << "Mean Squared Error: " << mse << endl;
+        cout << "R-squared: " << r_squared << endl;
+    }
+};
+
+// GradientEvaluation - MSE gradient and loss at one (slope, intercept)
+struct GradientEvaluation {
+    double slope_gradient;
+    double intercept_gradient;
+    double loss;
+};
+
+// SufficientStatistics Class - running moments of (x, y) in O(1) memory.
+// Uses Welford-style centered updates instead of raw sums of squares so the
+// slope stays accurate when x or y have a large offset.
+class SufficientStatistics {
+private:
+    size_t count;
+    double mean_x;
+    double mean_y;
+    double sxx;  // sum of (x - mean_x)^2
+    double syy;  // sum of (y - mean_y)^2
+    double sxy;  // sum of (x - mean_x) * (y - mean_y)
+
+public:
+    SufficientStatistics() : count(0), mean_x(0), mean_y(0), sxx(0), syy(0), sxy(0) {}
+    
+    void add(double x, double y) {
+        ++count;
+        double dx = x - mean_x;
+        double dy = y - mean_y;
+        mean_x += dx / count;
+        mean_y += dy / count;
+        sxx += dx * (x - mean_x);
+        syy += dy * (y - mean_y);
+        sxy += dx * (y - mean_y);
+    }
+    
+    // Fold in another set of moments (Chan et al. pairwise update)
+    void merge(const SufficientStatistics& other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        
+        double total = double(count) + other.count;
+        double dx = other.mean_x - mean_x;
+        double dy = other.mean_y - mean_y;
+        double weight = double(count) * other.count / total;
+        
+        mean_x += dx * other.count / total;
+        mean_y += dy * other.count / total;
+        sxx += other.sxx + dx * dx * weight;
+        syy += other.syy + dy * dy * weight;
+        sxy += other.sxy + dx * dy * weight;
+        count += other.count;
+    }
+    
+    // Add contiguous arrays block by block: each block is centered on its
+    // own means (two passes while it is still in cache) and then merged, which
+    // is as accurate as add() but vectorizes and needs no division per row
+    template <typename T>
+    void addRange(const T* x, const T* y, size_t n) {
+        const size_t block_rows = 1024;
+        
+        for (size_t start = 0; start < n; start += block_rows) {
+            size_t rows = min(block_rows, n - start);
+            const T* bx = x + start;
+            const T* by = y + start;
+            
+            double sum_x = 0.0, sum_y = 0.0;
+            for (size_t i = 0; i < rows; ++i) {
+                sum_x += bx[i];
+                sum_y += by[i];
+            }
+            
+            SufficientStatistics block;
+            block.count = rows;
+            block.mean_x = sum_x / rows;
+            block.mean_y = sum_y / rows;
+            for (size_t i = 0; i < rows; ++i) {
+                double dx = bx[i] - block.mean_x;
+                double dy = by[i] - block.mean_y;
+                block.sxx += dx * dx;
+                block.syy += dy * dy;
+                block.sxy += dx * dy;
+            }
+            merge(block);
+        }
+    }
+    
+    // Every row of two chunked columns
+    template <typename T>
+    void addColumns(const BasicColumnView<T>& x_vals, const BasicColumnView<T>& y_vals) {
+        forEachRowSpan(x_vals, y_vals, 0, x_vals.size(), [this](const T* x, const T* y, size_t n) {
+            addRange(x, y, n);
+        });
+    }
+    
+    // Undo add(x, y) for a point that was added earlier (sliding windows)
+    void remove(double x, double y) {
+        if (count <= 1) {
+            reset();
+            return;
+        }
+        
+        --count;
+        double previous_mean_x = mean_x - (x - mean_x) / count;
+        double previous_mean_y = mean_y - (y - mean_y) / count;
+        sxx -= (x - previous_mean_x) * (x - mean_x);
+        syy -= (y - previous_mean_y) * (y - mean_y);
+        sxy -= (x - previous_mean_x) * (y - mean_y);
+        mean_x = previous_mean_x;
+        mean_y = previous_mean_y;
+    }
+    
+    void reset() {
+        *this = SufficientStatistics();
+    }
+    
+    size_t getCount() const { return count; }
+    double getMeanX() const { return mean_x; }
+    double getMeanY() const { return mean_y; }
+    double getSxx() const { return sxx; }
+    double getSyy() const { return syy; }
+    double getSxy() const { return sxy; }
+    
+    // Least squares fit of the accumulated points
+    double slope() const { return sxy / sxx; }
+    double intercept() const { return mean_y - slope() * mean_x; }
+    
+    // MSE of the least squares line: (Syy - Sxy^2 / Sxx) / n
+    double mse() const {
+        if (count == 0) {
+            return 0.0;
+        }
+        double sse = syy - slope() * sxy;
+        return max(0.0, sse) / count;
+    }
+    
+    // R^2 of the least squares line: Sxy^2 / (Sxx Syy)
+    double rSquared() const {
+        return syy > 0 ? (sxy * sxy) / (sxx * syy) : 1.0;
+    }
+    
+    // R^2 of any line with the given MSE on these points
+    double rSquaredForMSE(double line_mse) const {
+        return syy > 0 ? 1.0 - line_mse * count / syy : (line_mse == 0.0 ? 1.0 : 0.0);
+    }
+    
+    // MSE loss and its gradient for an arbitrary line, in O(1). Written around
+    // the residual at the means, r = slope * mean_x + intercept - mean_y, so
+    // only centered moments appear and raw sums like sum(x^2) never cancel:
+    //   dL/dslope = 2 (slope * Sxx - Sxy) / n + 2 r mean_x,  dL/dintercept = 2 r
+    //   L = (slope^2 Sxx - 2 slope Sxy + Syy) / n + r^2
+    GradientEvaluation mseGradientAt(double line_slope, double line_intercept) const {
+        double r = line_slope * mean_x + line_intercept - mean_y;
+        GradientEvaluation result;
+        result.slope_gradient = 2.0 * (line_slope * sxx - sxy) / count + 2.0 * r * mean_x;
+        result.intercept_gradient = 2.0 * r;
+        result.loss = max(0.0, (line_slope * line_slope * sxx - 2.0 * line_slope * sxy + syy) / count) + r * r;
+        return result;
+    }
+};
+
+// GradientDescentModel Class
+// FullPass mode evaluates the gradient with a pass over the data each
+// iteration (SIMD, optionally multi-threaded). Moments mode collects the
+// sufficient statistics in one pass up front and then evaluates the same
+// gradient in O(1), so the iteration count no longer scales the cost.
+enum class GradientMode { FullPass, Moments };
+
+// Update rule applied to each gradient
+//   Plain    - theta -= lr * g
+//   Momentum - heavy ball: v = beta * v - lr * g, theta += v
+//   Nesterov - as Momentum, with g taken at the look-ahead point theta + beta * v
+//   Adam     - bias-corrected first/second moment estimates (beta, 0.999)
+//   Armijo   - backtracking line search: the step starts at twice the last
+//              accepted one and halves until the loss drops by c * t * |g|^2
+enum class Optimizer { Plain, Momentum, Nesterov, Adam, Armijo };
+
+string optimizerName(Optimizer optimizer) {
+    switch (optimizer) {
+        case Optimizer::Momentum: return "Momentum";
+        case Optimizer::Nesterov: return "Nesterov";
+        case Optimizer::Adam: return "Adam";
+        case Optimizer::Armijo: return "Armijo line search";
+        default: return "Plain";
+    }
+}
+
+// One sample of the optimizer's progress. Parameters are in the space the
+// optimizer works in, i.e. standardized units when standardization is on.
+struct TraceEntry {
+    int iteration;
+    double loss;            // MSE at the point the gradient was taken
+    double gradient_norm;
+    double slope;
+    double intercept;
+    double slope_delta;     // step applied in this iteration
+    double intercept_delta;
+};
+
+// ConvergenceTrace - fixed-capacity ring buffer of TraceEntry samples taken
+// every `every` iterations. All storage is allocated up front, so recording
+// in the training loop is a store and an index update; once full, the
+// oldest samples are overwritten and the most recent `capacity` are kept.
+class ConvergenceTrace {
+private:
+    vector<TraceEntry> entries;
+    size_t next_slot;
+    size_t recorded;
+    int every;
+
+public:
+    ConvergenceTrace() : next_slot(0), recorded(0), every(1) {}
+    
+    // capacity 0 disables tracing
+    void configure(size_t capacity, int sample_every) {
+        entries.assign(capacity, TraceEntry());
+        every = max(1, sample_every);
+        clear();
+    }
+    
+    void clear() {
+        next_slot = 0;
+        recorded = 0;
+    }
+    
+    bool isEnabled() const { return !entries.empty(); }
+    bool isDue(int iteration) const { return iteration % every == 0; }
+    
+    void record(const TraceEntry& entry) {
+        entries[next_slot] = entry;
+        next_slot = (next_slot + 1) % entries.size();
+        ++recorded;
+    }
+    
+    // Samples currently held, and the total ever recorded (more once wrapped)
+    size_t size() const { return min(recorded, entries.size()); }
+    size_t getRecorded() const { return recorded; }
+    
+    // i = 0 is the oldest sample still held
+    const TraceEntry& operator[](size_t i) const {
+        size_t oldest = recorded > entries.size() ? next_slot : 0;
+        return entries[(oldest + i) % entries.size()];
+    }
+    
+    const TraceEntry* last() const {
+        return recorded == 0 ? nullptr : &entries[(next_slot + entries.size() - 1) % entries.size()];
+    }
+    
+    void writeCSV(ostream& out) const {
+        ios::fmtflags flags = out.flags();
+        streamsize precision = out.precision(17);
+        out << "iteration,loss,gradient_norm,slope,intercept,slope_delta,intercept_delta\n";
+        for (size_t i = 0; i < size(); ++i) {
+            const TraceEntry& e = (*this)[i];
+            out << e.iteration << ',' << e.loss << ',' << e.gradient_norm << ',' << e.slope << ','
+                << e.intercept << ',' << e.slope_delta << ',' << e.intercept_delta << '\n';
+        }
+        out.precision(precision);
+        out.flags(flags);
+    }
+};
+
+struct GradientDescentOptions {
+    double learning_rate = 0.01;
+    int max_iterations = 1000;
+    double tolerance = 1e-6;
+    unsigned threads = 1;  // 1 = single-threaded, 0 = one per core
+    GradientMode mode = GradientMode::FullPass;
+    Optimizer optimizer = Optimizer::Plain;
+    double momentum = 0.9;  // beta for Momentum/Nesterov, beta1 for Adam
+    bool standardize = false;
+    size_t trace_capacity = 0;  // convergence trace samples kept, 0 = no trace
+    int trace_every = 1;        // sample every k-th iteration
+};
+
+class GradientDescentModel : public RegressionModel {
+private:
+    double learning_rate;
+    int max_iterations;
+    double tolerance;
+    GradientMode gradient_mode;
+    Optimizer optimizer;
+    double momentum;
+    bool standardize;
+    SimdLevel simd_level;
+    unsigned num_threads;
+    unsigned threads_used;
+    int iterations_run;
+    size_t gradient_evaluations;
+    double final_gradient_norm;
+    double train_seconds;
+    size_t train_rows;
+    bool converged;
+    ConvergenceTrace trace;
+    
+    // Below this many rows per thread the wake-up cost outweighs the work
+    static const size_t MIN_ROWS_PER_THREAD = 16384;
+    
+    static constexpr double ADAM_BETA2 = 0.999;
+    static constexpr double ADAM_EPSILON = 1e-8;
+    static constexpr double ARMIJO_C = 1e-4;
+    static constexpr double ARMIJO_MIN_STEP = 1e-30;
+    
+    // Per-thread partial sums, padded so threads never share a cache line
+    struct alignas(64) PartialSums {
+        GradientSums sums;
+    };
+    
+    // Iterate from (slope, intercept) with the selected optimizer
+    void optimize(const function<GradientEvaluation(double, double)>& evaluate_at) {
+        auto evaluate = [&](double s, double b) {
+            ++gradient_evaluations;
+            return evaluate_at(s, b);
+        };
+        
+        double velocity_slope = 0.0, velocity_intercept = 0.0;  // Momentum/Nesterov, Adam first moment
+        double second_slope = 0.0, second_intercept = 0.0;      // Adam second moment
+        double beta1_power = 1.0, beta2_power = 1.0;
+        double step = learning_rate;                             // Armijo
+        bool have_gradient = false;
+        GradientEvaluation gradient = {0.0, 0.0, 0.0};
+        
+        for (int iter = 0; iter < max_iterations; ++iter) {
+            double new_slope, new_intercept;
+            
+            if (optimizer == Optimizer::Nesterov) {
+                gradient = evaluate(slope + momentum * velocity_slope,
+                                    intercept + momentum * velocity_intercept);
+            } else if (!have_gradient) {
+                gradient = evaluate(slope, intercept);
+            }
+            have_gradient = false;
+            double loss_before_step = gradient.loss;
+            
+            switch (optimizer) {
+                case Optimizer::Momentum:
+                case Optimizer::Nesterov:
+                    velocity_slope = momentum * velocity_slope - learning_rate * gradient.slope_gradient;
+                    velocity_intercept = momentum * velocity_intercept - learning_rate * gradient.intercept_gradient;
+                    new_slope = slope + velocity_slope;
+                    new_intercept = intercept + velocity_intercept;
+                    break;
+                
+                case Optimizer::Adam: {
+                    beta1_power *= momentum;
+                    beta2_power *= ADAM_BETA2;
+                    velocity_slope = momentum * velocity_slope + (1 - momentum) * gradient.slope_gradient;
+                    velocity_intercept = momentum * velocity_intercept + (1 - momentum) * gradient.intercept_gradient;
+                    second_slope = ADAM_BETA2 * second_slope
+                                 + (1 - ADAM_BETA2) * gradient.slope_gradient * gradient.slope_gradient;
+                    second_intercept = ADAM_BETA2 * second_intercept
+                                     + (1 - ADAM_BETA2) * gradient.intercept_gradient * gradient.intercept_gradient;
+                    
+                    double m_slope = velocity_slope / (1 - beta1_power);
+                    double m_intercept = velocity_intercept / (1 - beta1_power);
+                    double v_slope = second_slope / (1 - beta2_power);
+                    double v_intercept = second_intercept / (1 - beta2_power);
+                    new_slope = slope - learning_rate * m_slope / (sqrt(v_slope) + ADAM_EPSILON);
+                    new_intercept = intercept - learning_rate * m_intercept / (sqrt(v_intercept) + ADAM_EPSILON);
+                    break;
+                }
+                
+                case Optimizer::Armijo: {
+                    double squared_norm = gradient.slope_gradient * gradient.slope_gradient
+                                        + gradient.intercept_gradient * gradient.intercept_gradient;
+                    double t = (iter == 0) ? learning_rate : 2.0 * step;
+                    GradientEvaluation candidate;
+                    
+                    while (true) {
+                        new_slope = slope - t * gradient.slope_gradient;
+                        new_intercept = intercept - t * gradient.intercept_gradient;
+                        candidate = evaluate(new_slope, new_intercept);
+                        if (candidate.loss <= gradient.loss - ARMIJO_C * t * squared_norm ||
+                            t < ARMIJO_MIN_STEP) {
+                            break;
+                        }
+                        t *= 0.5;
+                    }
+                    step = t;
+                    
+                    // The accepted point's gradient is the next iteration's gradient
+                    final_gradient_norm = hypot(gradient.slope_gradient, gradient.intercept_gradient);
+                    gradient = candidate;
+                    have_gradient = true;
+                    break;
+                }
+                
+                default:
+                    new_slope = slope - learning_rate * gradient.slope_gradient;
+                    new_intercept = intercept - learning_rate * gradient.intercept_gradient;
+                    break;
+            }
+            
+            ++iterations_run;
+            if (optimizer != Optimizer::Armijo) {
+                final_gradient_norm = hypot(gradient.slope_gradient, gradient.intercept_gradient);
+            }
+            
+            // Check for convergence
+            bool done = abs(new_slope - slope) < tolerance && abs(new_intercept - intercept) < tolerance;
+            // A momentum step is also tiny whenever the velocity changes sign,
+            // far from the minimum, so those optimizers need a flat gradient too
+            if (optimizer == Optimizer::Momentum || optimizer == Optimizer::Nesterov) {
+                done = done && final_gradient_norm < tolerance;
+            }
+            
+            // Always sample the last iteration so the trace ends where training did
+            if (trace.isEnabled() && (trace.isDue(iter) || done || iter + 1 == max_iterations)) {
+                trace.record({iter, loss_before_step, final_gradient_norm, new_slope, new_intercept,
+                              new_slope - slope, new_intercept - intercept});
+            }
+            
+            if (done) {
+                converged = true;
+                break;
+            }
+            
+            slope = new_slope;
+            intercept = new_intercept;
+        }
+    }
+
+public:
+    explicit GradientDescentModel(const GradientDescentOptions& options)
+        : learning_rate(options.learning_rate), max_iterations(options.max_iterations),
+          tolerance(options.tolerance), gradient_mode(options.mode), optimizer(options.optimizer),
+          momentum(options.momentum), standardize(options.standardize),
+          simd_level(detectSimdLevel()), num_threads(options.threads),
+          threads_used(1), iterations_run(0), gradient_evaluations(0), final_gradient_norm(0),
+          train_seconds(0), train_rows(0), converged(false) {
+        trace.configure(options.trace_capacity, options.trace_every);
+    }
+    
+    GradientDescentModel(double lr = 0.01, int max_iter = 1000, double tol = 1e-6,
+                         unsigned threads = 1, GradientMode mode = GradientMode::FullPass) 
+        : GradientDescentModel(GradientDescentOptions{lr, max_iter, tol, threads, mode}) {}
+    
+    string getMethodName() const override { return "Gradient Descent"; }
+    
+    void train(const Dataset& dataset) override {
+        dataset.visitColumns([&](auto x_vals, auto y_vals) { trainColumns(dataset, x_vals, y_vals); });
+    }
+    
+    template <typename T>
+    void trainColumns(const Dataset& dataset, BasicColumnView<T> x_vals, BasicColumnView<T> y_vals) {
+        if (x_vals.empty()) {
+            throw runtime_error("Dataset is empty");
+        }
+        
+        // Initialize parameters
+        slope = 0.0;
+        intercept = 0.0;
+        
+        size_t n = x_vals.size();
+        auto start_time = chrono::steady_clock::now();
+        iterations_run = 0;
+        gradient_evaluations = 0;
+        final_gradient_norm = 0.0;
+        converged = false;
+        trace.clear();
+        
+        // Moments mode and standardization both need one statistics pass
+        SufficientStatistics stats;
+        if (gradient_mode == GradientMode::Moments || standardize) {
+            stats.addColumns(x_vals, y_vals);
+        }
+        
+        function<GradientEvaluation(double, double)> evaluate;
+        unique_ptr<ThreadPool> pool;
+        vector<PartialSums> partials;
+        function<void(size_t)> slice_task;
+        GradientKernelFor<T> kernel = selectGradientKernel<T>(simd_level);
+        double eval_slope = 0.0;
+        double eval_intercept = 0.0;
+        
+        if (gradient_mode == GradientMode::Moments) {
+            threads_used = 1;
+            evaluate = [&](double s, double b) { return stats.mseGradientAt(s, b); };
+        } else {
+            // Each thread owns a fixed slice for the whole run; the pool lives
+            // only as long as this call
+            threads_used = static_cast<unsigned>(
+                max<size_t>(1, min<size_t>(resolveThreadCount(num_threads), n / MIN_ROWS_PER_THREAD)));
+            pool = make_unique<ThreadPool>(threads_used);
+            partials.resize(threads_used);
+            
+            slice_task = [&](size_t t) {
+                size_t begin = n * t / threads_used;
+                size_t end = n * (t + 1) / threads_used;
+                partials[t].sums = gradientSumsRange(kernel, x_vals, y_vals, begin, end,
+                                                     eval_slope, eval_intercept);
+            };
+            
+            // Calculate both gradients in one pass, reducing the slices in a
+            // fixed order so results do not depend on thread timing
+            evaluate = [&](double s, double b) {
+                eval_slope = s;
+                eval_intercept = b;
+                pool->run(slice_task);
+                
+                GradientSums sums = {0.0, 0.0, 0.0};
+                for (const auto& partial : partials) {
+                    sums.error_x += partial.sums.error_x;
+                    sums.error += partial.sums.error;
+                    sums.squared_error += partial.sums.squared_error;
+                }
+                
+                double scale = 2.0 / n;
+                return GradientEvaluation{scale * sums.error_x, scale * sums.error,
+                                          sums.squared_error / n};
+            };
+        }
+        
+        if (!standardize) {
+            optimize(evaluate);
+        } else {
+            // Optimize a, b for (y - mean_y) / sd_y = a * (x - mean_x) / sd_x + b,
+            // whose loss has Hessian 2I whatever the units of x and y. Each
+            // standardized gradient comes from the raw gradient at the
+            // equivalent line by the chain rule, so the data is never copied.
+            // The tolerance applies to a and b.
+            double mean_x = stats.getMeanX();
+            double mean_y = stats.getMeanY();
+            double sd_x = sqrt(stats.getSxx() / n);
+            double sd_y = sqrt(stats.getSyy() / n);
+            if (!(sd_x > 0)) sd_x = 1.0;
+            if (!(sd_y > 0)) sd_y = 1.0;
+            
+            auto to_raw_slope = [&](double a) { return a * sd_y / sd_x; };
+            auto to_raw_intercept = [&](double a, double b) {
+                return mean_y + sd_y * b - to_raw_slope(a) * mean_x;
+            };
+            
+            optimize([&](double a, double b) {
+                GradientEvaluation raw = evaluate(to_raw_slope(a), to_raw_intercept(a, b));
+                return GradientEvaluation{(raw.slope_gradient - mean_x * raw.intercept_gradient) / (sd_x * sd_y),
+                                          raw.intercept_gradient / sd_y,
+                                          raw.loss / (sd_y * sd_y)};
+            });
+            
+            double a = slope;
+            double b = intercept;
+            slope = to_raw_slope(a);
+            intercept = to_raw_intercept(a, b);
+        }
+        
+        train_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        train_rows = n;
+        LR_METRICS_COUNT("gd_iterations", iterations_run);
+        LR_METRICS_COUNT("gradient_evaluations", gradient_evaluations);
+        LR_METRICS_GAUGE("final_gradient_norm", final_gradient_norm);
+        
+        // The moments already give MSE and R^2 of the final line in O(1)
+        if (stats.getCount() > 0) {
+            mse = stats.mseGradientAt(slope, intercept).loss;
+            r_squared = stats.rSquaredForMSE(mse);
+        } else {
+            updateMetrics(dataset);
+        }
+    }
+    
+    void setParameters(double lr, int max_iter, double tol) {
+        learning_rate = lr;
+        max_iterations = max_iter;
+        tolerance = tol;
+    }
+    
+    void setGradientMode(GradientMode mode) { gradient_mode = mode; }
+    GradientMode getGradientMode() const { return gradient_mode; }
+    
+    // Train on standardized x and y and map the line back to original units
+    void setStandardize(bool enabled) { standardize = enabled; }
+    bool getStandardize() const { return standardize; }
+    
+    void setOptimizer(Optimizer new_optimizer, double beta = 0.9) {
+        optimizer = new_optimizer;
+        momentum = beta;
+    }
+    Optimizer getOptimizer() const { return optimizer; }
+    
+    // Force a narrower kernel (e.g. Scalar to compare results); wider
+    // levels than the CPU supports fall back automatically
+    void setSimdLevel(SimdLevel level) { simd_level = level; }
+    SimdLevel getSimdLevel() const { return min(simd_level, detectSimdLevel()); }
+    
+    // 1 = single-threaded, 0 = one thread per core
+    void setThreads(unsigned threads) { num_threads = threads; }
+    unsigned getThreadsUsed() const { return threads_used; }
+    
+    int getIterations() const { return iterations_run; }
+    double getTrainSeconds() const { return train_seconds; }
+    
+    // Number of gradient/loss evaluations; in FullPass mode each one is a
+    // pass over the data (line search needs more than one per iteration)
+    size_t getGradientEvaluations() const { return gradient_evaluations; }
+    
+    // Norm of the last gradient the optimizer acted on
+    double getFinalGradientNorm() const { return final_gradient_norm; }
+    
+    // True when the tolerance check stopped training, false when
+    // max_iterations ran out
+    bool hasConverged() const { return converged; }
+    
+    // Keep the last `capacity` samples, one every `every` iterations;
+    // capacity 0 turns tracing off. Takes effect from the next train().
+    void setTrace(size_t capacity, int every = 1) { trace.configure(capacity, every); }
+    const ConvergenceTrace& getTrace() const { return trace; }
+    
+    // Rows processed per second, per pass over the data
+    double getRowsPerSecond() const {
+        return train_seconds > 0 ? double(train_rows) * gradient_evaluations / train_seconds : 0.0;
+    }
+    
+    void displayResults() const override {
+        RegressionModel::displayResults();
+        cout << "Optimizer: " << optimizerName(optimizer) << (standardize ? ", standardized" : "")
+             << " (" << iterations_run << " iterations, " << gradient_evaluations
+             << " gradient evaluations, final gradient norm " << final_gradient_norm << ")" << endl;
+        cout << "Stopped: " << (converged ? "converged within tolerance" : "max_iterations reached") << endl;
+        if (gradient_mode == GradientMode::Moments) {
+            cout << "Gradient: moments, O(1) per iteration (" << train_seconds << " s)" << endl;
+        } else {
+            cout << "Gradient: " << simdLevelName(getSimdLevel()) << " kernel, " << threads_used
+                 << " thread(s), " << getRowsPerSecond() << " rows/s per pass" << endl;
+        }
+    }
+};
+
+// MiniBatchGradientDescentModel Class - stochastic gradient descent over
+// mini-batches, so each update costs O(batch_size) instead of O(n).
+// Rows are shuffled each epoch as short contiguous strips rather than one
+// by one: every strip is read sequentially (cache and prefetch friendly)
+// while a batch still mixes rows from all over the dataset.
+// Like GradientDescentModel it optimizes the standardized line by default,
+// so one learning rate suits data in any units, and the step decays as
+// learning_rate / (1 + LEARNING_RATE_DECAY * epoch) so the mini-batch noise
+// dies down and the per-epoch tolerance can be met.
+class MiniBatchGradientDescentModel : public RegressionModel {
+private:
+    double learning_rate;
+    int max_epochs;
+    size_t batch_size;
+    double tolerance;
+    uint64_t seed;
+    bool standardize;
+    SimdLevel simd_level;
+    int epochs_run;
+    size_t updates_run;
+    double train_seconds;
+    
+    static constexpr size_t STRIP_ROWS = 64;
+    static constexpr double LEARNING_RATE_DECAY = 0.05;
+
+public:
+    // For the standardized problem, whose full-batch loss has Hessian 2I
+    static constexpr double DEFAULT_LEARNING_RATE = 0.1;
+    
+    MiniBatchGradientDescentModel(double lr = DEFAULT_LEARNING_RATE, int max_epochs = 100, size_t batch_size = 256,
+                                  double tol = 1e-6, uint64_t seed = 42)
+        : learning_rate(lr), max_epochs(max_epochs), batch_size(max<size_t>(1, batch_size)),
+          tolerance(tol), seed(seed), standardize(true), simd_level(detectSimdLevel()),
+          epochs_run(0), updates_run(0), train_seconds(0) {}
+    
+    string getMethodName() const override { return "Mini-batch Gradient Descent"; }
+    
+    void train(const Dataset& dataset) override {
+        dataset.visitColumns([&](auto x_vals, auto y_vals) { trainColumns(dataset, x_vals, y_vals); });
+    }
+    
+    template <typename T>
+    void trainColumns(const Dataset& dataset, BasicColumnView<T> x_vals, BasicColumnView<T> y_vals) {
+        if (x_vals.empty()) {
+            throw runtime_error("Dataset is empty");
+        }
+        
+        size_t n = x_vals.size();
+        
+        // Optimize a, b for (y - mean_y) / sd_y = a * (x - mean_x) / sd_x + b;
+        // each batch gradient comes from the raw one by the chain rule, as
+        // in GradientDescentModel. Without standardization the transform is
+        // the identity.
+        double mean_x = 0.0, mean_y = 0.0, sd_x = 1.0, sd_y = 1.0;
+        if (standardize) {
+            SufficientStatistics stats;
+            stats.addColumns(x_vals, y_vals);
+            mean_x = stats.getMeanX();
+            mean_y = stats.getMeanY();
+            sd_x = sqrt(stats.getSxx() / n);
+            sd_y = sqrt(stats.getSyy() / n);
+            if (!(sd_x > 0)) sd_x = 1.0;
+            if (!(sd_y > 0)) sd_y = 1.0;
+        }
+        auto to_raw_slope = [&](double a) { return a * sd_y / sd_x; };
+        auto to_raw_intercept = [&](double a, double b) { return mean_y + sd_y * b - to_raw_slope(a) * mean_x; };
+        
+        // Initialize parameters
+        double a = 0.0;
+        double b = 0.0;
+        slope = to_raw_slope(a);
+        intercept = to_raw_intercept(a, b);
+        
+        size_t strip_rows = min(STRIP_ROWS, batch_size);
+        size_t num_strips = (n + strip_rows - 1) / strip_rows;
+        size_t strips_per_batch = max<size_t>(1, batch_size / strip_rows);
+        
+        vector<uint32_t> strip_order(num_strips);
+        iota(strip_order.begin(), strip_order.end(), 0u);
+        mt19937_64 rng(seed);
+        
+        GradientKernelFor<T> kernel = selectGradientKernel<T>(simd_level);
+        auto start_time = chrono::steady_clock::now();
+        epochs_run = 0;
+        updates_run = 0;
+        
+        for (int epoch = 0; epoch < max_epochs; ++epoch) {
+            shuffle(strip_order.begin(), strip_order.end(), rng);
+            double epoch_start_a = a;
+            double epoch_start_b = b;
+            double step = learning_rate / (1.0 + LEARNING_RATE_DECAY * epoch);
+            
+            for (size_t first = 0; first < num_strips; first += strips_per_batch) {
+                size_t last = min(first + strips_per_batch, num_strips);
+                GradientSums sums = {0.0, 0.0, 0.0};
+                size_t batch_rows = 0;
+                
+                // Calculate gradients over the strips of this batch
+                for (size_t s = first; s < last; ++s) {
+                    size_t begin = size_t(strip_order[s]) * strip_rows;
+                    size_t rows = min(strip_rows, n - begin);
+                    GradientSums strip = gradientSumsRange(kernel, x_vals, y_vals, begin, begin + rows,
+                                                           slope, intercept);
+                    sums.error_x += strip.error_x;
+                    sums.error += strip.error;
+                    batch_rows += rows;
+                }
+                
+                // Update parameters
+                double scale = 2.0 / batch_rows;
+                double slope_gradient = scale * sums.error_x;
+                double intercept_gradient = scale * sums.error;
+                a -= step * (slope_gradient - mean_x * intercept_gradient) / (sd_x * sd_y);
+                b -= step * intercept_gradient / sd_y;
+                slope = to_raw_slope(a);
+                intercept = to_raw_intercept(a, b);
+                ++updates_run;
+            }
+            ++epochs_run;
+            
+            if (!isfinite(slope) || !isfinite(intercept)) {
+                throw runtime_error("Mini-batch gradient descent diverged; use a smaller learning rate");
+            }
+            
+            // Check for convergence over a whole epoch; single steps are too noisy
+            if (abs(a - epoch_start_a) < tolerance && abs(b - epoch_start_b) < tolerance) {
+                break;
+            }
+        }
+        
+        train_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        LR_METRICS_COUNT("sgd_epochs", epochs_run);
+        LR_METRICS_COUNT("sgd_updates", updates_run);
+        updateMetrics(dataset);
+    }
+    
+    void setParameters(double lr, int epochs, size_t batch, double tol) {
+        learning_rate = lr;
+        max_epochs = epochs;
+        batch_size = max<size_t>(1, batch);
+        tolerance = tol;
+    }
+    
+    void setSeed(uint64_t new_seed) { seed = new_seed; }
+    
+    // Train on standardized x and y and map the line back to original units
+    void setStandardize(bool enabled) { standardize = enabled; }
+    bool getStandardize() const { return standardize; }
+    
+    int getEpochs() const { return epochs_run; }
+    size_t getUpdates() const { return updates_run; }
+    double getTrainSeconds() const { return train_seconds; }
+    
+    void displayResults() const override {
+        RegressionModel::displayResults();
+        cout << "Epochs: " << epochs_run << " (" << updates_run << " mini-batch updates of "
+             << batch_size << " rows, " << train_seconds << " s)" << endl;
+    }
+};
+
+// StreamingLeastSquaresModel Class - least squares from a single pass over
+// a Dataset, a CSV file or stdin without storing any rows. It is also the
+// online model: added points update the moments, so the fit stays current.
+class StreamingLeastSquaresModel : public RegressionModel {
+private:
+    SufficientStatistics stats;
+    string x_label;
+    string y_label;
+    size_t invalid_rows;
+    
+    void finish() {
+        if (stats.getCount() == 0) {
+            throw runtime_error("Dataset is empty");
+        }
+        slope = stats.slope();
+        intercept = stats.intercept();
+        mse = stats.mse();
+        r_squared = stats.rSquared();
+    }
+
+public:
+    StreamingLeastSquaresModel() : x_label("X"), y_label("Y"), invalid_rows(0) {}
+    
+    string getMethodName() const override { return "Streaming Least Squares"; }
+    
+    void train(const Dataset& dataset) override {
+        stats.reset();
+        dataset.visitColumns([this](auto x_vals, auto y_vals) {
+            stats.addColumns(x_vals, y_vals);
+        });
+        x_label = dataset.getXLabel();
+        y_label = dataset.getYLabel();
+        finish();
+    }
+    
+    bool isIncremental() const override { return true; }
+    
+    void addObservations(const double* x, const double* y, size_t n) override {
+        if (n == 1) {
+            stats.add(x[0], y[0]);
+        } else {
+            stats.addRange(x, y, n);
+        }
+        if (stats.getCount() > 0) {
+            finish();
+        }
+    }
+    
+    size_t getObservationCount() const override { return stats.getCount(); }
+    
+    // Same header and row rules as Dataset::loadFromCSV
+    void trainFromStream(istream& in) {
+        stats.reset();
+        invalid_rows = 0;
+        bool first_line = true;
+        
+        forEachStreamLine(in, [&](const char* begin, const char* end) {
+            if (first_line) {
+                first_line = false;
+                if (skipCSVHeader(begin, end, x_label, y_label) != begin) {
+                    return;
+                }
+            }
+            
+            double x, y;
+            CSVRowStatus status = parseCSVRow(begin, end, x, y);
+            if (status == CSVRowStatus::Valid) {
+                stats.add(x, y);
+            } else if (status == CSVRowStatus::Invalid) {
+                ++invalid_rows;
+                cerr << "Warning: Invalid data in line: ";
+                cerr.write(begin, end - begin);
+                cerr << endl;
+            }
+        });
+        
+        if (stats.getCount() == 0) {
+            throw runtime_error("No valid data found in input");
+        }
+        finish();
+    }
+    
+    void trainFromFile(const string& filename) {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open()) {
+            throw runtime_error("Cannot open file: " + filename);
+        }
+        trainFromStream(file);
+    }
+    
+    size_t getCount() const { return stats.getCount(); }
+    size_t getInvalidRows() const { return invalid_rows; }
+    string getXLabel() const { return x_label; }
+    string getYLabel() const { return y_label; }
+};
+
+// SlidingWindowModel Class - least squares over the last `capacity` points.
+// A ring buffer holds the window; each new point is added to the moments and
+// the point it evicts is removed, both in O(1). The moments are rebuilt from
+// the buffer once per `capacity` evictions so rounding cannot accumulate.
+class SlidingWindowModel : public RegressionModel {
+private:
+    vector<double> window_x;
+    vector<double> window_y;
+    size_t capacity;
+    size_t next_slot;
+    size_t filled;
+    size_t evictions;
+    SufficientStatistics stats;
+    
+    void refresh() {
+        if (stats.getCount() > 0) {
+            slope = stats.slope();
+            intercept = stats.intercept();
+            mse = stats.mse();
+            r_squared = stats.rSquared();
+        }
+    }
+    
+    void push(double x, double y) {
+        if (filled == capacity) {
+            stats.remove(window_x[next_slot], window_y[next_slot]);
+            if (++evictions == capacity) {
+                evictions = 0;
+                window_x[next_slot] = x;
+                window_y[next_slot] = y;
+                next_slot = (next_slot + 1) % capacity;
+                stats.reset();
+                stats.addRange(window_x.data(), window_y.data(), filled);
+                return;
+            }
+        } else {
+            ++filled;
+        }
+        
+        window_x[next_slot] = x;
+        window_y[next_slot] = y;
+        next_slot = (next_slot + 1) % capacity;
+        stats.add(x, y);
+    }
+
+public:
+    explicit SlidingWindowModel(size_t capacity)
+        : window_x(max<size_t>(2, capacity)), window_y(max<size_t>(2, capacity)),
+          capacity(max<size_t>(2, capacity)), next_slot(0), filled(0), evictions(0) {}
+    
+    string getMethodName() const override { return "Sliding Window Least Squares"; }
+    
+    void train(const Dataset& dataset) override {
+        size_t n = dataset.getSize();
+        if (n == 0) {
+            throw runtime_error("Dataset is empty");
+        }
+        
+        next_slot = 0;
+        filled = 0;
+        evictions = 0;
+        stats.reset();
+        
+        // Only the most recent points can end up in the window
+        size_t start = n > capacity ? n - capacity : 0;
+        dataset.forEachDoubleBlock(start, [this](const double* x, const double* y, size_t rows) {
+            addObservations(x, y, rows);
+        });
+    }
+    
+    bool isIncremental() const override { return true; }
+    bool needsHistory() const override { return false; }
+    
+    void addObservations(const double* x, const double* y, size_t n) override {
+        for (size_t i = 0; i < n; ++i) {
+            push(x[i], y[i]);
+        }
+        refresh();
+    }
+    
+    size_t getObservationCount() const override { return filled; }
+    size_t getCapacity() const { return capacity; }
+    
+    // Scored on the window itself; older dataset rows are not part of the fit
+    RegressionMetrics evaluateFit(const Dataset& dataset) const override {
+        (void)dataset;
+        if (filled == 0) {
+            return RegressionMetrics();
+        }
+        static const ErrorKernel kernel = selectErrorKernel<double>(detectSimdLevel());
+        ErrorSums sums = kernel(window_x.data(), window_y.data(), filled, slope, intercept, window_y[0]);
+        return metricsFromErrorSums(sums, filled);
+    }
+    
+    void displayResults() const override {
+        RegressionModel::displayResults();
+        cout << "Window: last " << filled << " of " << capacity << " points" << endl;
+    }
+};
+
+// DecayedRegressionModel Class - least squares with exponential forgetting.
+// Before each new point every earlier weight is multiplied by
+// forgetting_factor (0 < factor <= 1), so a point k updates old has weight
+// factor^k and the effective memory is about 1 / (1 - factor) points.
+// Only weighted moments are kept, no points at all.
+class DecayedRegressionModel : public RegressionModel {
+private:
+    double forgetting_factor;
+    double weight;  // sum of current weights
+    double mean_x;
+    double mean_y;
+    double sxx;
+    double syy;
+    double sxy;
+    size_t observations;
+    
+    void reset() {
+        weight = mean_x = mean_y = sxx = syy = sxy = 0.0;
+        observations = 0;
+    }
+    
+    // Weighted Welford update with weight 1 for the new point
+    void push(double x, double y) {
+        weight *= forgetting_factor;
+        sxx *= forgetting_factor;
+        syy *= forgetting_factor;
+        sxy *= forgetting_factor;
+        
+        weight += 1.0;
+        double dx = x - mean_x;
+        double dy = y - mean_y;
+        mean_x += dx / weight;
+        mean_y += dy / weight;
+        sxx += dx * (x - mean_x);
+        syy += dy * (y - mean_y);
+        sxy += dx * (y - mean_y);
+        ++observations;
+    }
+    
+    void refresh() {
+        if (observations == 0) {
+            return;
+        }
+        slope = sxy / sxx;
+        intercept = mean_y - slope * mean_x;
+        mse = max(0.0, syy - slope * sxy) / weight;
+        r_squared = syy > 0 ? (sxy * sxy) / (sxx * syy) : 1.0;
+    }
+
+public:
+    explicit DecayedRegressionModel(double factor)
+        : forgetting_factor(factor) {
+        if (!(factor > 0.0 && factor <= 1.0)) {
+            throw runtime_error("Forgetting factor must be in (0, 1]");
+        }
+        reset();
+    }
+    
+    string getMethodName() const override { return "Exponentially Decayed Least Squares"; }
+    
+    void train(const Dataset& dataset) override {
+        if (dataset.getSize() == 0) {
+            throw runtime_error("Dataset is empty");
+        }
+        
+        reset();
+        dataset.forEachDoubleBlock(0, [this](const double* x, const double* y, size_t rows) {
+            addObservations(x, y, rows);
+        });
+    }
+    
+    bool isIncremental() const override { return true; }
+    bool needsHistory() const override { return false; }
+    
+    void addObservations(const double* x, const double* y, size_t n) override {
+        for (size_t i = 0; i < n; ++i) {
+            push(x[i], y[i]);
+        }
+        refresh();
+    }
+    
+    size_t getObservationCount() const override { return observations; }
+    double getEffectiveWeight() const { return weight; }
+    
+    // Points within the effective memory, about 1 / (1 - factor)
+    size_t getEffectiveMemory() const {
+        if (forgetting_factor >= 1.0) {
+            return observations;
+        }
+        return min(observations, static_cast<size_t>(ceil(1.0 / (1.0 - forgetting_factor))));
+    }
+    
+    // MSE and R^2 carry the fit's own weights, MAE is weighted the same way
+    // and max error covers the effective memory. The last two need the
+    // points in the dataset; without them only the moments are known
+    RegressionMetrics evaluateFit(const Dataset& dataset) const override {
+        RegressionMetrics metrics;
+        metrics.count = observations;
+        metrics.mse = mse;
+        metrics.rmse = sqrt(mse);
+        metrics.r_squared = r_squared;
+        if (dataset.getSize() != observations) {
+            metrics.mae = metrics.max_error = numeric_limits<double>::quiet_NaN();
+            return metrics;
+        }
+        
+        double total_weight = 0.0;
+        double absolute_error = 0.0;
+        size_t remaining = observations;
+        size_t memory = getEffectiveMemory();
+        dataset.forEachDoubleBlock(0, [&](const double* x, const double* y, size_t rows) {
+            for (size_t i = 0; i < rows; ++i, --remaining) {
+                double error = abs(y[i] - predict(x[i]));
+                total_weight = total_weight * forgetting_factor + 1.0;
+                absolute_error = absolute_error * forgetting_factor + error;
+                if (remaining <= memory) {
+                    metrics.max_error = max(metrics.max_error, error);
+                }
+            }
+        });
+        metrics.mae = absolute_error / total_weight;
+        return metrics;
+    }
+    
+    void displayResults() const override {
+        RegressionModel::displayResults();
+        cout << "Decay: factor " << forgetting_factor << ", effective weight " << weight
+             << " over " << observations << " points" << endl;
+    }
+};
+
+// LeastSquaresModel Class
+class LeastSquaresModel : public RegressionModel {
+public:
+    string getMethodName() const override { return "Least Squares"; }
+    
+    void train(const Dataset& dataset) override {
+        dataset.visitColumns([this](auto x_vals, auto y_vals) { trainColumns(x_vals, y_vals); });
+    }
+    
+    template <typename T>
+    void trainColumns(BasicColumnView<T> x_vals, BasicColumnView<T> y_vals) {
+        if (x_vals.empty()) {
+            throw runtime_error("Dataset is empty");
+        }
+        
+        size_t n = x_vals.size();
+        
+        // Calculate means
+        double x_sum = 0.0;
+        double y_sum = 0.0;
+        forEachRowSpan(x_vals, y_vals, 0, n, [&](const T* x, const T* y, size_t rows) {
+            x_sum = accumulate(x, x + rows, x_sum);
+            y_sum = accumulate(y, y + rows, y_sum);
+        });
+        double x_mean = x_sum / n;
+        double y_mean = y_sum / n;
+        
+        // Calculate slope and intercept using least squares formula
+        double numerator = 0.0;
+        double denominator = 0.0;
+        double y_variation = 0.0;
+        
+        forEachRowSpan(x_vals, y_vals, 0, n, [&](const T* x, const T* y, size_t rows) {
+            for (size_t i = 0; i < rows; ++i) {
+                double dx = x[i] - x_mean;
+                double dy = y[i] - y_mean;
+                numerator += dx * dy;
+                denominator += dx * dx;
+                y_variation += dy * dy;
+            }
+        });
+        
+        slope = numerator / denominator;
+        intercept = y_mean - slope * x_mean;
+        
+        // At the least squares optimum SSE = Syy - slope * Sxy and
+        // R^2 = Sxy^2 / (Sxx Syy), so no extra pass is needed
+        mse = max(0.0, y_variation - slope * numerator) / n;
+        r_squared = y_variation > 0 ? (numerator * numerator) / (denominator * y_variation) : 1.0;
+    }
+};
+
+// Everything needed to use a trained model again without its data
+struct ModelRecord {
+    string method;
+    string x_label;
+    string y_label;
+    double slope = 0.0;
+    double intercept = 0.0;
+    double mse = 0.0;
+    double r_squared = 0.0;
+    uint64_t row_count = 0;
+    uint64_t data_fingerprint = 0;  // datasetFingerprint() of the training data
+};
+
+// 64-bit FNV-1a style hash of the row count and every x and y bit pattern,
+// one word at a time. Identifies the training data, not a security hash.
+uint64_t datasetFingerprint(const Dataset& dataset) {
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+    
+    auto mix = [&](uint64_t word) {
+        hash = (hash ^ word) * prime;
+    };
+    
+    // Values are hashed as doubles, so float32 storage fingerprints the same
+    // as double storage holding the same rounded values
+    mix(dataset.getSize());
+    dataset.visitColumns([&](auto x_vals, auto y_vals) {
+        for (auto column : {x_vals, y_vals}) {
+            column.forEachSpan(0, column.size(), [&](const auto* values, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    double value = values[i];
+                    uint64_t bits;
+                    memcpy(&bits, &value, sizeof(bits));
+                    mix(bits);
+                }
+            });
+        }
+    });
+    return hash;
+}
+
+// .lrmodel layout: this header, then the method, x label and y label bytes
+struct BinaryModelHeader {
+    char magic[8];           // "LRMODEL" followed by a zero
+    uint32_t version;
+    uint32_t method_length;
+    uint32_t x_label_length;
+    uint32_t y_label_length;
+    double slope;
+    double intercept;
+    double mse;
+    double r_squared;
+    uint64_t row_count;
+    uint64_t data_fingerprint;
+};
+
+const char BINARY_MODEL_MAGIC[8] = {'L', 'R', 'M', 'O', 'D', 'E', 'L', 0};
+const uint32_t BINARY_MODEL_VERSION = 1;
+
+// Written to a temporary file and renamed, like the dataset cache
+void saveModelFile(const string& filename, const ModelRecord& record) {
+    BinaryModelHeader header = {};
+    memcpy(header.magic, BINARY_MODEL_MAGIC, sizeof(header.magic));
+    header.version = BINARY_MODEL_VERSION;
+    header.method_length = static_cast<uint32_t>(record.method.size());
+    header.x_label_length = static_cast<uint32_t>(record.x_label.size());
+    header.y_label_length = static_cast<uint32_t>(record.y_label.size());
+    header.slope = record.slope;
+    header.intercept = record.intercept;
+    header.mse = record.mse;
+    header.r_squared = record.r_squared;
+    header.row_count = record.row_count;
+    header.data_fingerprint = record.data_fingerprint;
+    
+    string temp_filename = filename + ".tmp";
+    {
+        ofstream file(temp_filename, ios::binary | ios::trunc);
+        if (!file.is_open()) {
+            throw runtime_error("Cannot create file: " + temp_filename);
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(record.method.data(), record.method.size());
+        file.write(record.x_label.data(), record.x_label.size());
+        file.write(record.y_label.data(), record.y_label.size());
+        if (!file) {
+            throw runtime_error("Failed writing file: " + temp_filename);
+        }
+    }
+    filesystem::rename(temp_filename, filename);
+}
+
+ModelRecord loadModelFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Cannot open file: " + filename);
+    }
+    
+    BinaryModelHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, BINARY_MODEL_MAGIC, sizeof(header.magic)) != 0) {
+        throw runtime_error("Not a saved model: " + filename);
+    }
+    if (header.version != BINARY_MODEL_VERSION) {
+        throw runtime_error("Unsupported model version in: " + filename);
+    }
+    
+    // Labels come from CSV headers, so anything this long means corruption
+    const uint32_t max_text_length = 1 << 16;
+    if (header.method_length > max_text_length || header.x_label_length > max_text_length ||
+        header.y_label_length > max_text_length) {
+        throw runtime_error("Corrupt saved model: " + filename);
+    }
+    
+    ModelRecord record;
+    record.method.resize(header.method_length);
+    record.x_label.resize(header.x_label_length);
+    record.y_label.resize(header.y_label_length);
+    file.read(&record.method[0], header.method_length);
+    file.read(&record.x_label[0], header.x_label_length);
+    file.read(&record.y_label[0], header.y_label_length);
+    if (!file) {
+        throw runtime_error("Truncated saved model: " + filename);
+    }
+    
+    record.slope = header.slope;
+    record.intercept = header.intercept;
+    record.mse = header.mse;
+    record.r_squared = header.r_squared;
+    record.row_count = header.row_count;
+    record.data_fingerprint = header.data_fingerprint;
+    return record;
+}
+
+// Human-readable "key = value" export; doubles use round-trip precision
+void writeModelText(ostream& out, const ModelRecord& record) {
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision(17);
+    out << "format = lrmodel " << BINARY_MODEL_VERSION << "\n"
+        << "method = " << record.method << "\n"
+        << "x_label = " << record.x_label << "\n"
+        << "y_label = " << record.y_label << "\n"
+        << "slope = " << record.slope << "\n"
+        << "intercept = " << record.intercept << "\n"
+        << "mse = " << record.mse << "\n"
+        << "r_squared = " << record.r_squared << "\n"
+        << "rows = " << record.row_count << "\n"
+        << "data_fingerprint = " << hex << setw(16) << setfill('0') << record.data_fingerprint
+        << dec << setfill(' ') << "\n";
+    out.precision(precision);
+    out.flags(flags);
+}
+
+// SavedModel Class - a model restored from a .lrmodel file. It predicts
+// immediately; it cannot be retrained because the method's settings are not
+// stored, only its result.
+class SavedModel : public RegressionModel {
+private:
+    ModelRecord record;
+
+public:
+    explicit SavedModel(const ModelRecord& record) : record(record) {
+        slope = record.slope;
+        intercept = record.intercept;
+        mse = record.mse;
+        r_squared = record.r_squared;
+    }
+    
+    string getMethodName() const override { return record.method; }
+    
+    void train(const Dataset& dataset) override {
+        (void)dataset;
+        throw runtime_error("A saved model cannot be retrained; select a training method first");
+    }
+    
+    const ModelRecord& getRecord() const { return record; }
+};
+
+// MultipleRegressionModel Class - y = b0 + b1 x1 + ... + bp xp by least squares.
+// Features and target are centered on their means, the p x p matrix Xc'Xc
+// and the vector Xc'yc are accumulated in row blocks sized to stay in cache
+// (one partial per thread, reduced in a fixed order), and the normal
+// equations are solved by Cholesky factorization. Centering keeps the
+// intercept out of the system and greatly improves its conditioning.
+class MultipleRegressionModel {
+private:
+    vector<double> coefficients;
+    double intercept;
+    double mse;
+    double r_squared;
+    unsigned num_threads;
+    unsigned threads_used;
+    double train_seconds;
+    vector<string> feature_labels;
+    string target_label;
+    
+    // Solve A x = b in place for symmetric positive definite A (p x p,
+    // row-major); A is overwritten by its Cholesky factor
+    static vector<double> choleskySolve(vector<double>& a, vector<double> b, size_t p,
+                                        const vector<string>& labels) {
+        for (size_t j = 0; j < p; ++j) {
+            double original = a[j * p + j];
+            double diagonal = original;
+            for (size_t k = 0; k < j; ++k) {
+                diagonal -= a[j * p + k] * a[j * p + k];
+            }
+            // Relative pivot check: rounding can leave a tiny positive value
+            // for a column that is a combination of the previous ones
+            if (!(diagonal > 1e-12 * original)) {
+                throw runtime_error("Features are collinear or constant (at " + labels[j] +
+                                    "); normal equations are singular");
+            }
+            double root = sqrt(diagonal);
+            a[j * p + j] = root;
+            
+            for (size_t i = j + 1; i < p; ++i) {
+                double value = a[i * p + j];
+                for (size_t k = 0; k < j; ++k) {
+                    value -= a[i * p + k] * a[j * p + k];
+                }
+                a[i * p + j] = value / root;
+            }
+        }
+        
+        // Forward substitution L z = b, then back substitution L' x = z
+        for (size_t i = 0; i < p; ++i) {
+            for (size_t k = 0; k < i; ++k) {
+                b[i] -= a[i * p + k] * b[k];
+            }
+            b[i] /= a[i * p + i];
+        }
+        for (size_t i = p; i-- > 0;) {
+            for (size_t k = i + 1; k < p; ++k) {
+                b[i] -= a[k * p + i] * b[k];
+            }
+            b[i] /= a[i * p + i];
+        }
+        return b;
+    }
+
+public:
+    explicit MultipleRegressionModel(unsigned threads = 0)
+        : intercept(0), mse(0), r_squared(0), num_threads(threads), threads_used(1),
+          train_seconds(0), target_label("Y") {}
+    
+    void train(const MultiDataset& dataset) {
+        size_t n = dataset.getSize();
+        size_t p = dataset.getFeatureCount();
+        if (n == 0 || p == 0) {
+            throw runtime_error("Dataset is empty");
+        }
+        if (n <= p) {
+            throw runtime_error("Need more rows than features for multiple regression");
+        }
+        
+        auto start_time = chrono::steady_clock::now();
+        const double* y = dataset.getTargets();
+        
+        // Calculate means
+        vector<double> means(p);
+        for (size_t j = 0; j < p; ++j) {
+            const double* column = dataset.getFeatureColumn(j);
+            means[j] = accumulate(column, column + n, 0.0) / n;
+        }
+        double y_mean = accumulate(y, y + n, 0.0) / n;
+        
+        // Rows per block: all p centered columns of one block fit in ~512 KB
+        size_t block_rows = min<size_t>(1024, max<size_t>(64, (512 * 1024 / sizeof(double)) / (p + 1)));
+        threads_used = static_cast<unsigned>(
+            max<size_t>(1, min<size_t>(resolveThreadCount(num_threads), n / block_rows)));
+        
+        // Per-thread partial Gram matrix (upper triangle), X'y and y'y
+        vector<vector<double>> partial_gram(threads_used, vector<double>(p * p, 0.0));
+        vector<vector<double>> partial_xty(threads_used, vector<double>(p, 0.0));
+        vector<double> partial_yty(threads_used * 8, 0.0);  // strided to avoid false sharing
+        DotKernel dot = selectDotKernel(detectSimdLevel());
+        
+        ThreadPool pool(threads_used);
+        pool.run([&](size_t t) {
+            size_t row_begin = n * t / threads_used;
+            size_t row_end = n * (t + 1) / threads_used;
+            vector<double> block((p + 1) * block_rows);
+            vector<double>& gram = partial_gram[t];
+            vector<double>& xty = partial_xty[t];
+            double yty = 0.0;
+            
+            for (size_t start = row_begin; start < row_end; start += block_rows) {
+                size_t rows = min(block_rows, row_end - start);
+                
+                // Center this block of every column into the buffer
+                for (size_t j = 0; j < p; ++j) {
+                    const double* column = dataset.getFeatureColumn(j) + start;
+                    double* centered = block.data() + j * block_rows;
+                    for (size_t i = 0; i < rows; ++i) {
+                        centered[i] = column[i] - means[j];
+                    }
+                }
+                double* centered_y = block.data() + p * block_rows;
+                for (size_t i = 0; i < rows; ++i) {
+                    centered_y[i] = y[start + i] - y_mean;
+                }
+                
+                for (size_t j = 0; j < p; ++j) {
+                    const double* column_j = block.data() + j * block_rows;
+                    for (size_t k = j; k < p; ++k) {
+                        gram[j * p + k] += dot(column_j, block.data() + k * block_rows, rows);
+                    }
+                    xty[j] += dot(column_j, centered_y, rows);
+                }
+                yty += dot(centered_y, centered_y, rows);
+            }
+            partial_yty[t * 8] = yty;
+        });
+        
+        vector<double> gram(p * p, 0.0);
+        vector<double> xty(p, 0.0);
+        double yty = 0.0;
+        for (unsigned t = 0; t < threads_used; ++t) {
+            for (size_t j = 0; j < p; ++j) {
+                for (size_t k = j; k < p; ++k) {
+                    gram[j * p + k] += partial_gram[t][j * p + k];
+                }
+                xty[j] += partial_xty[t][j];
+            }
+            yty += partial_yty[t * 8];
+        }
+        for (size_t j = 0; j < p; ++j) {
+            for (size_t k = 0; k < j; ++k) {
+                gram[j * p + k] = gram[k * p + j];
+            }
+        }
+        
+        feature_labels = dataset.getFeatureLabels();
+        target_label = dataset.getTargetLabel();
+        coefficients = choleskySolve(gram, xty, p, feature_labels);
+        
+        intercept = y_mean;
+        double explained = 0.0;
+        for (size_t j = 0; j < p; ++j) {
+            intercept -= coefficients[j] * means[j];
+            explained += coefficients[j] * xty[j];
+        }
+        
+        // At the optimum SSE = yc'yc - beta' Xc'yc
+        mse = max(0.0, yty - explained) / n;
+        r_squared = yty > 0 ? 1.0 - (mse * n) / yty : 1.0;
+        train_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    }
+    
+    // features points to getFeatureCount() values
+    double predict(const double* features) const {
+        static const DotKernel dot = selectDotKernel(detectSimdLevel());
+        return intercept + dot(coefficients.data(), features, coefficients.size());
+    }
+    
+    double predict(const vector<double>& features) const {
+        if (features.size() != coefficients.size()) {
+            throw runtime_error("Expected " + to_string(coefficients.size()) + " features");
+        }
+        return predict(features.data());
+    }
+    
+    const vector<double>& getCoefficients() const { return coefficients; }
+    double getIntercept() const { return intercept; }
+    double getMSE() const { return mse; }
+    double getRSquared() const { return r_squared; }
+    size_t getFeatureCount() const { return coefficients.size(); }
+    
+    void displayResults() const {
+        cout << "\n*** Multiple Regression Results ***" << endl;
+        cout << target_label << " = " << fixed << setprecision(4) << intercept;
+        for (size_t j = 0; j < coefficients.size(); ++j) {
+            cout << " + " << coefficients[j] << " * " << feature_labels[j];
+        }
+        cout << defaultfloat << setprecision(6) << endl;
+        cout << "Intercept: " << intercept << endl;
+        cout << "Mean Squared Error: " << mse << endl;
+        cout << "R-squared: " << r_squared << endl;
+        cout << "Solve: " << threads_used << " thread(s), " << train_seconds << " s" << endl;
+    }
+};
+
+// LinearRegression Main Class
+class LinearRegression {
+private:
+    unique_ptr<RegressionModel> model;
+    Dataset dataset;
+    StoragePrecision storage_precision;
+    bool is_trained;
+    bool verbose;
+    
+    // Multi-feature model, used through the *Multiple* methods
+    unique_ptr<MultipleRegressionModel> multi_model;
+    MultiDataset multi_dataset;
+    bool multi_trained;
+    
+    // Bring an incremental model up to date with the whole dataset (one pass)
+    void syncIncrementalModel() {
+        if (model && model->isIncremental() && dataset.getSize() > 0) {
+            model->train(dataset);
+            is_trained = model->getObservationCount() >= 2;
+        }
+    }
+
+public:
+    LinearRegression() : storage_precision(StoragePrecision::Double), is_trained(false),
+                         verbose(true), multi_trained(false) {}
+    
+    // Turn off progress messages on stdout (e.g. when stdout carries data)
+    void setVerbose(bool enabled) { verbose = enabled; }
+    
+    // Float32 halves dataset memory; see StoragePrecision for the accuracy
+    // cost. Converts data already loaded and applies to later loads.
+    void setStoragePrecision(StoragePrecision precision) {
+        storage_precision = precision;
+        dataset.setStoragePrecision(precision);
+    }
+    StoragePrecision getStoragePrecision() const { return storage_precision; }
+    
+    // Uses the .lrbin cache next to the CSV when it is newer than the CSV.
+    // Otherwise num_threads = 1 parses on the calling thread, 0 uses every core.
+    void loadData(const string& filename, unsigned num_threads = 1) {
+        if (isBinaryCacheFresh(filename)) {
+            try {
+                // The cache keeps its own precision; convert if it differs
+                dataset.loadFromBinary(binaryCachePath(filename));
+                dataset.setStoragePrecision(storage_precision);
+                is_trained = false;
+                syncIncrementalModel();
+                return;
+            } catch (const exception& e) {
+                cerr << "Warning: Ignoring binary cache: " << e.what() << endl;
+            }
+        }
+        
+        if (num_threads == 1) {
+            dataset.loadFromCSVMapped(filename);
+        } else {
+            dataset.loadFromCSVParallel(filename, num_threads);
+        }
+        is_trained = false;
+        syncIncrementalModel();
+    }
+    
+    // Start from a model written by saveModel(): predict() works at once,
+    // in time independent of the size of the original dataset
+    void loadModel(const string& filename) {
+        LR_METRICS_PHASE("load_model");
+        ModelRecord record = loadModelFile(filename);
+        dataset = Dataset();
+        dataset.setStoragePrecision(storage_precision);
+        dataset.setLabels(record.x_label, record.y_label);
+        model = make_unique<SavedModel>(record);
+        is_trained = true;
+    }
+    
+    ModelRecord getModelRecord() const {
+        if (!is_trained || !model) {
+            throw runtime_error("Model not trained. Call trainModel() first.");
+        }
+        if (const SavedModel* saved = dynamic_cast<const SavedModel*>(model.get())) {
+            return saved->getRecord();
+        }
+        
+        ModelRecord record;
+        record.method = model->getMethodName();
+        record.x_label = dataset.getXLabel();
+        record.y_label = dataset.getYLabel();
+        record.slope = model->getSlope();
+        record.intercept = model->getIntercept();
+        record.mse = model->getMSE();
+        record.r_squared = model->getRSquared();
+        record.row_count = dataset.getSize();
+        record.data_fingerprint = datasetFingerprint(dataset);
+        return record;
+    }
+    
+    void saveModel(const string& filename) const {
+        saveModelFile(filename, getModelRecord());
+    }
+    
+    void exportModelText(ostream& out) const {
+        writeModelText(out, getModelRecord());
+    }
+    
+    // With an incremental model the new point updates the fit in O(1);
+    // otherwise the model must be retrained
+    void addDataPoint(double x, double y) {
+        addDataPoints(&x, &y, 1);
+    }
+    
+    // Windowed models keep their own bounded state, so their points are not
+    // stored in the dataset
+    void addDataPoints(const double* x, const double* y, size_t n) {
+        if (!model || model->needsHistory()) {
+            dataset.addDataPoints(x, y, n);
+        }
+        if (model && model->isIncremental()) {
+            model->addObservations(x, y, n);
+            is_trained = model->getObservationCount() >= 2;
+        } else {
+            is_trained = false;
+        }
+    }
+    
+    void addDataPoints(const vector<double>& x, const vector<double>& y) {
+        if (x.size() != y.size()) {
+            throw runtime_error("x and y must have the same number of values");
+        }
+        addDataPoints(x.data(), y.data(), x.size());
+    }
+    
+    // threads: 1 = single-threaded, 0 = one per core. GradientMode::Moments
+    // makes every iteration O(1) after one pass over the data.
+    void useGradientDescent(double lr = 0.01, int max_iter = 1000, double tol = 1e-6,
+                            unsigned threads = 1, GradientMode mode = GradientMode::FullPass) {
+        model = make_unique<GradientDescentModel>(lr, max_iter, tol, threads, mode);
+        is_trained = false;
+    }
+    
+    void useGradientDescent(const GradientDescentOptions& options) {
+        model = make_unique<GradientDescentModel>(options);
+        is_trained = false;
+    }
+    
+    // Mini-batch SGD; batch_size = 1 gives plain stochastic gradient descent
+    void useMiniBatchGradientDescent(double lr = MiniBatchGradientDescentModel::DEFAULT_LEARNING_RATE,
+                                     int max_epochs = 100, size_t batch_size = 256,
+                                     double tol = 1e-6, uint64_t seed = 42, bool standardize = true) {
+        auto mini_batch = make_unique<MiniBatchGradientDescentModel>(lr, max_epochs, batch_size, tol, seed);
+        mini_batch->setStandardize(standardize);
+        model = move(mini_batch);
+        is_trained = false;
+    }
+    
+    void useLeastSquares() {
+        model = make_unique<LeastSquaresModel>();
+        is_trained = false;
+    }
+    
+    void useStreamingLeastSquares() {
+        model = make_unique<StreamingLeastSquaresModel>();
+        is_trained = false;
+        syncIncrementalModel();
+    }
+    
+    // Least squares over the last `capacity` points; memory is O(capacity)
+    // and each addDataPoint is O(1)
+    void useSlidingWindow(size_t capacity) {
+        model = make_unique<SlidingWindowModel>(capacity);
+        is_trained = false;
+        syncIncrementalModel();
+    }
+    
+    // Exponentially decayed least squares with no stored points;
+    // forgetting_factor in (0, 1], e.g. 0.999 remembers about 1000 points
+    void useExponentialDecay(double forgetting_factor) {
+        model = make_unique<DecayedRegressionModel>(forgetting_factor);
+        is_trained = false;
+        syncIncrementalModel();
+    }
+    
+    // Online least squares: after one pass over the current data, every
+    // addDataPoint/addDataPoints keeps slope, intercept and MSE current
+    // without calling trainModel()
+    void useOnlineLeastSquares() {
+        useStreamingLeastSquares();
+    }
+    
+    void trainModel() {
+        if (!model) {
+            throw runtime_error("No regression model selected. Use useGradientDescent() or useLeastSquares() first.");
+        }
+        
+        // Windowed models are already current with every point they were
+        // given, and the dataset does not hold those points to retrain from
+        if (model->isIncremental() && !model->needsHistory()) {
+            if (model->getObservationCount() < 2) {
+                throw runtime_error("Insufficient data for training. Need at least 2 data points.");
+            }
+            is_trained = true;
+            return;
+        }
+        
+        if (dataset.getSize() < 2) {
+            throw runtime_error("Insufficient data for training. Need at least 2 data points.");
+        }
+        
+        if (verbose) cout << "Training model..." << endl;
+        {
+            LR_METRICS_PHASE("train");
+            model->train(dataset);
+        }
+        is_trained = true;
+        LR_METRICS_COUNT("rows_trained", dataset.getSize());
+        if (verbose) cout << "Training completed!" << endl;
+    }
+    
+    double predict(double x) const {
+        if (!is_trained || !model) {
+            throw runtime_error("Model not trained. Call trainModel() first.");
+        }
+        return model->predict(x);
+    }
+    
+    // Checks the model once, then predicts the whole span
+    void predictBatch(const double* x, double* out, size_t n) const {
+        if (!is_trained || !model) {
+            throw runtime_error("Model not trained. Call trainModel() first.");
+        }
+        model->predictBatch(x, out, n);
+        LR_METRICS_COUNT("predictions", n);
+    }
+    
+    vector<double> predictBatch(const vector<double>& x) const {
+        vector<double> out(x.size());
+        predictBatch(x.data(), out.data(), x.size());
+        return out;
+    }
+    
+    void displayResults() const {
+        if (!is_trained || !model) {
+            throw runtime_error("Model not trained. Call trainModel() first.");
+        }
+        model->displayResults();
+    }
+    
+    // Multi-feature CSV: every column but the last is a feature
+    void loadMultipleData(const string& filename) {
+        multi_dataset.loadFromCSV(filename);
+        multi_trained = false;
+    }
+    
+    void addMultipleDataPoint(const vector<double>& features, double y) {
+        multi_dataset.addRow(features, y);
+        multi_trained = false;
+    }
+    
+    // threads: 1 = single-threaded, 0 = one per core
+    void useMultipleRegression(unsigned threads = 0) {
+        multi_model = make_unique<MultipleRegressionModel>(threads);
+        multi_trained = false;
+    }
+    
+    void trainMultipleModel() {
+        if (!multi_model) {
+            throw runtime_error("No multiple regression model selected. Use useMultipleRegression() first.");
+        }
+        if (multi_dataset.getSize() <= multi_dataset.getFeatureCount()) {
+            throw runtime_error("Insufficient data for training. Need more rows than features.");
+        }
+        
+        if (verbose) cout << "Training model..." << endl;
+        LR_METRICS_PHASE("train_multiple");
+        multi_model->train(multi_dataset);
+        multi_trained = true;
+        if (verbose) cout << "Training completed!" << endl;
+    }
+    
+    double predictMultiple(const vector<double>& features) const {
+        if (!multi_trained || !multi_model) {
+            throw runtime_error("Model not trained. Call trainMultipleModel() first.");
+        }
+        return multi_model->predict(features);
+    }
+    
+    void displayMultipleResults() const {
+        if (!multi_trained || !multi_model) {
+            throw runtime_error("Model not trained. Call trainMultipleModel() first.");
+        }
+        multi_model->displayResults();
+    }
+    
+    void displayMultipleDatasetSummary() const {
+        multi_dataset.displaySummary();
+    }
+    
+    // Full set of fit metrics on the data the model was fitted to (one extra
+    // pass; window and decay models score their own window or weighting)
+    RegressionMetrics evaluateModel() const {
+        if (!is_trained || !model) {
+            throw runtime_error("Model not trained. Call trainModel() first.");
+        }
+        return model->evaluateFit(dataset);
+    }
+    
+    void displayEvaluation() const {
+        RegressionMetrics metrics = evaluateModel();
+        cout << "\n*** Model Evaluation ***" << endl;
+        cout << "MSE: " << metrics.mse << endl;
+        cout << "RMSE: " << metrics.rmse << endl;
+        cout << "MAE: " << metrics.mae << endl;
+        cout << "R-squared: " << metrics.r_squared << endl;
+        cout << "Max Error: " << metrics.max_error << endl;
+    }
+    
+    void displayDatasetSummary() const {
+        dataset.displaySummary();
+    }
+    
+    bool isModelTrained() const {
+        return is_trained;
+    }
+    
+    // ADD THIS MISSING METHOD
+    const Dataset& getDataset() const {
+        return dataset;
+    }
+    
+    const RegressionModel& getModel() const {
+        if (!model) {
+            throw runtime_error("No regression model selected.");
+        }
+        return *model;
+    }
+};
+
+// Bulk scoring: read x values (first column, optional header) from input
+// and write "x,prediction" rows to output, in blocks with no per-line
+// flushing. Returns the number of rows scored.
+size_t scoreCSVStream(const LinearRegression& lr, istream& input, ostream& output) {
+    LR_METRICS_PHASE("score");
+    const size_t block_rows = 1 << 16;
+    // Longest shortest-form double is 24 chars; two per row plus ',' and '\n'
+    const size_t max_row_chars = 2 * 24 + 2;
+    
+    vector<double> inputs;
+    vector<double> predictions(block_rows);
+    vector<char> text(block_rows * max_row_chars);
+    inputs.reserve(block_rows);
+    size_t rows_scored = 0;
+    bool first_line = true;
+    
+    auto flush_block = [&]() {
+        lr.predictBatch(inputs.data(), predictions.data(), inputs.size());
+        
+        char* cursor = text.data();
+        char* text_end = text.data() + text.size();
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            cursor = to_chars(cursor, text_end, inputs[i]).ptr;
+            *cursor++ = ',';
+            cursor = to_chars(cursor, text_end, predictions[i]).ptr;
+            *cursor++ = '\n';
+        }
+        output.write(text.data(), cursor - text.data());
+        
+        rows_scored += inputs.size();
+        inputs.clear();
+    };
+    
+    output << "x,predicted_" << lr.getDataset().getYLabel() << "\n";
+    
+    forEachStreamLine(input, [&](const char* begin, const char* end) {
+        const char* field_end = find(begin, end, ',');
+        double x;
+        
+        if (!parseCSVNumber(begin, field_end, x)) {
+            // A non-numeric first line is a header; anything later is bad data
+            if (!first_line && begin != end) {
+                cerr << "Warning: Invalid data in line: ";
+                cerr.write(begin, end - begin);
+                cerr << endl;
+            }
+            first_line = false;
+            return;
+        }
+        first_line = false;
+        
+        inputs.push_back(x);
+        if (inputs.size() == block_rows) {
+            flush_block();
+        }
+    });
+    
+    if (!inputs.empty()) {
+        flush_block();
+    }
+    output.flush();
+    return rows_scored;
+}
+
+// Category definitions with all datasets
+map<string, pair<string, string>> categories = {
+    {"1", {"Education", "Study hours vs Exam scores"}},
+    {"2", {"Real Estate", "House size vs Price"}},
+    {"3", {"Business", "Advertising budget vs Sales"}},
+    {"4", {"Healthcare", "Treatment duration vs Recovery rate"}},
+    {"5", {"Sports", "Training hours vs Performance score"}},
+    {"6", {"Salary Prediction", "Years of experience vs Salary"}},
+    {"7", {"Temperature Analysis", "Temperature vs Ice Cream Sales"}},
+    {"8", {"Car Valuation", "Car age vs Price"}},
+    {"9", {"Custom", "Your own dataset"}}
+};
+
+// Function to display categories
+void displayCategories() {
+    cout << "\n*** SELECT CATEGORY ***" << endl;
+    cout << "==========================================" << endl;
+    for (const auto& category : categories) {
+        cout << category.first << ". " << category.second.first << endl;
+        cout << "   - " << category.second.second << endl;
+    }
+    cout << "==========================================" << endl;
+}
+
+// Function to get category-specific prompt
+pair<string, string> getCategoryPrompts(const string& categoryId) {
+    map<string, pair<string, string>> prompts = {
+        {"1", {"study hours", "exam score"}},
+        {"2", {"house size (sqft)", "price ($)"}},
+        {"3", {"advertising budget ($)", "sales amount ($)"}},
+        {"4", {"treatment duration (days)", "recovery rate (%)"}},
+        {"5", {"training hours", "performance score"}},
+        {"6", {"years of experience", "salary ($)"}},
+        {"7", {"temperature (C)", "ice cream sales"}},
+        {"8", {"car age (years)", "price ($)"}},
+        {"9", {"input value", "output value"}}
+    };
+    
+    return prompts[categoryId];
+}
+
+// Function to create sample CSV for a category
+void createSampleCSV(const string& categoryId, const string& filename) {
+    ofstream file(filename);
+    
+    if (categoryId == "1") {
+        // Education sample
+        file << "Study_Hours,Exam_Score" << endl;
+        file << "1,45" << endl;
+        file << "2,55" << endl;
+        file << "3,65" << endl;
+        file << "4,75" << endl;
+        file << "5,85" << endl;
+        file << "6,80" << endl;
+        file << "7,90" << endl;
+        file << "8,95" << endl;
+        file << "9,92" << endl;
+        file << "10,98" << endl;
+    }
+    else if (categoryId == "2") {
+        // Real Estate sample
+        file << "Size_sqft,Price" << endl;
+        file << "800,250000" << endl;
+        file << "1000,300000" << endl;
+        file << "1200,350000" << endl;
+        file << "1500,400000" << endl;
+        file << "1800,450000" << endl;
+        file << "2000,500000" << endl;
+        file << "2200,520000" << endl;
+        file << "2500,580000" << endl;
+    }
+    else if (categoryId == "3") {
+        // Business sample
+        file << "Advertising_Budget,Sales" << endl;
+        file << "500,3000" << endl;
+        file << "1000,5000" << endl;
+        file << "1500,6500" << endl;
+        file << "2000,8000" << endl;
+        file << "2500,9500" << endl;
+        file << "3000,12000" << endl;
+        file << "4000,15000" << endl;
+        file << "5000,18000" << endl;
+    }
+    else if (categoryId == "4") {
+        // Healthcare sample
+        file << "Treatment_Days,Recovery_Rate" << endl;
+        file << "3,20" << endl;
+        file << "5,30" << endl;
+        file << "7,40" << endl;
+        file << "10,50" << endl;
+        file << "15,65" << endl;
+        file << "20,75" << endl;
+        file << "25,80" << endl;
+        file << "30,85" << endl;
+    }
+    else if (categoryId == "5") {
+        // Sports sample
+        file << "Training_Hours,Performance_Score" << endl;
+        file << "5,40" << endl;
+        file << "10,60" << endl;
+        file << "15,65" << endl;
+        file << "20,75" << endl;
+        file << "25,80" << endl;
+        file << "30,85" << endl;
+        file << "35,88" << endl;
+        file << "40,90" << endl;
+    }
+    else if (categoryId == "6") {
+        // Salary sample
+        file << "Years_Experience,Salary" << endl;
+        file << "1,35000" << endl;
+        file << "2,40000" << endl;
+        file << "3,45000" << endl;
+        file << "4,50000" << endl;
+        file << "5,55000" << endl;
+        file << "6,60000" << endl;
+        file << "7,65000" << endl;
+        file << "8,70000" << endl;
+    }
+    else if (categoryId == "7") {
+        // Temperature sample
+        file << "Temperature,Ice_Cream_Sales" << endl;
+        file << "15,100" << endl;
+        file << "18,120" << endl;
+        file << "20,150" << endl;
+        file << "22,180" << endl;
+        file << "25,220" << endl;
+        file << "28,260" << endl;
+        file << "30,300" << endl;
+        file << "32,320" << endl;
+    }
+    else if (categoryId == "8") {
+        // Car valuation sample
+        file << "Car_Age,Price" << endl;
+        file << "0,30000" << endl;
+        file << "1,27000" << endl;
+        file << "2,24000" << endl;
+        file << "3,22000" << endl;
+        file << "4,20000" << endl;
+        file << "5,18000" << endl;
+        file << "6,16000" << endl;
+        file << "7,14000" << endl;
+    }
+    else if (categoryId == "9") {
+        // Custom sample
+        file << "Input,Output" << endl;
+        file << "1,10" << endl;
+        file << "2,20" << endl;
+        file << "3,30" << endl;
+        file << "4,40" << endl;
+        file << "5,50" << endl;
+        file << "6,60" << endl;
+        file << "7,70" << endl;
+        file << "8,80" << endl;
+    }
+    
+    file.close();
+    cout << "*** SUCCESS: Created sample file: " << filename << endl;
+    cout << "*** INFO: Sample data created with realistic values for " << categories[categoryId].first << endl;
+}
+
+// Function to check if file exists
+bool fileExists(const string& filename) {
+    ifstream file(filename);
+    return file.good();
+}
+
+// Function to display dataset suggestions
+void displayDatasetSuggestions(const string& categoryId) {
+    map<string, string> suggestions = {
+        {"1", "student_data.csv, education_data.csv, marks_data.csv"},
+        {"2", "housing_data.csv, real_estate_data.csv, property_data.csv"},
+        {"3", "business_data.csv, sales_data.csv, advertising_data.csv"},
+        {"4", "healthcare_data.csv, medical_data.csv, recovery_data.csv"},
+        {"5", "sports_data.csv, training_data.csv, performance_data.csv"},
+        {"6", "salary_data.csv, experience_data.csv, income_data.csv"},
+        {"7", "temperature_data.csv, weather_data.csv, sales_data.csv"},
+        {"8", "car_data.csv, vehicle_data.csv, auto_data.csv"},
+        {"9", "Any CSV file with two columns (input,output)"}
+    };
+    
+    cout << "*** SUGGESTION: " << suggestions[categoryId] << endl;
+}
+
+// Function to show current directory
+void showCurrentDirectory() {
+    char buffer[1024];
+#ifdef _WIN32
+    char* cwd = _getcwd(buffer, sizeof(buffer));
+#else
+    char* cwd = getcwd(buffer, sizeof(buffer));
+#endif
+    if (cwd != NULL) {
+        cout << "*** Current directory: " << buffer << endl;
+    }
+}
+
+// Function to create all sample datasets at once
+void createAllSampleDatasets() {
+    cout << "\n*** CREATING ALL SAMPLE DATASETS ***" << endl;
+    createSampleCSV("1", "student_data.csv");
+    createSampleCSV("2", "housing_data.csv");
+    createSampleCSV("3", "business_data.csv");
+    createSampleCSV("4", "healthcare_data.csv");
+    createSampleCSV("5", "sports_data.csv");
+    createSampleCSV("6", "salary_data.csv");
+    createSampleCSV("7", "temperature_data.csv");
+    createSampleCSV("8", "car_data.csv");
+    createSampleCSV("9", "custom_data.csv");
+    cout << "*** SUCCESS: All sample datasets created successfully!" << endl;
+}
+
+// Main category-based workflow
+void runCategoryWorkflow() {
+    LinearRegression lr;
+    string categoryId;
+    string currentCategory;
+    bool datasetsCreated = false;
+    
+    // Show current directory
+    showCurrentDirectory();
+    
+    // Step 1: Ask about creating datasets FIRST
+    cout << "\nWould you like to create all sample datasets first? (y/n): ";
+    char createChoice;
+    cin >> createChoice;
+    
+    if (createChoice == 'y' || createChoice == 'Y') {
+        createAllSampleDatasets();
+        datasetsCreated = true;
+        cout << "\n*** NOTE: Sample datasets are now available in your current directory ***" << endl;
+    }
+    
+    // Step 2: Category Selection
+    displayCategories();
+    cout << "Enter category number (1-9): ";
+    cin >> categoryId;
+    
+    if (categories.find(categoryId) == categories.end()) {
+        cout << "*** ERROR: Invalid category selection!" << endl;
+        return;
+    }
+    
+    currentCategory = categories[categoryId].first;
+    cout << "\n*** SELECTED: " << currentCategory << endl;
+    cout << "*** DESCRIPTION: " << categories[categoryId].second << endl;
+    
+    // Step 3: File Path Handling - SMART LOGIC
+    string filepath;
+    map<string, string> defaultFiles = {
+        {"1", "student_data.csv"},
+        {"2", "housing_data.csv"},
+        {"3", "business_data.csv"},
+        {"4", "healthcare_data.csv"},
+        {"5", "sports_data.csv"},
+        {"6", "salary_data.csv"},
+        {"7", "temperature_data.csv"},
         {"8", "car_data.csv"},
         {"9", "custom_data.csv"}
     };
     
-    if (datasetsCreated) {
-        // If datasets were created, automatically use the corresponding file
-        filepath = defaultFiles[categoryId];
-        cout << "\n*** AUTOMATICALLY USING: " << filepath << endl;
+    if (datasetsCreated) {
+        // If datasets were created, automatically use the corresponding file
+        filepath = defaultFiles[categoryId];
+        cout << "\n*** AUTOMATICALLY USING: " << filepath << endl;
+    } else {
+        // If no datasets created, ask for file path
+        cout << "\n*** ENTER CSV FILE PATH ***" << endl;
+        displayDatasetSuggestions(categoryId);
+        
+        // Suggest the default file for this category
+        cout << "Suggested file: " << defaultFiles[categoryId] << endl;
+        cout << "Enter the path to your CSV file: ";
+        cin >> filepath;
+        
+        // If file doesn't exist, offer to create sample
+        if (!fileExists(filepath)) {
+            cout << "*** ERROR: File not found: " << filepath << endl;
+            cout << "Would you like to create a sample dataset? (y/n): ";
+            char choice;
+            cin >> choice;
+            
+            if (choice == 'y' || choice == 'Y') {
+                createSampleCSV(categoryId, filepath);
+            } else {
+                cout << "*** ERROR: Please provide a valid CSV file path." << endl;
+                return;
+            }
+        }
+    }
+    
+    // Step 4: Load Data
+    try {
+        cout << "\n*** LOADING DATA FROM: " << filepath << endl;
+        lr.loadData(filepath);
+        lr.displayDatasetSummary();
+    } catch (const exception& e) {
+        cout << "*** ERROR loading file: " << e.what() << endl;
+        return;
+    }
+    
+    // Step 5: Model Selection
+    cout << "\n*** SELECT REGRESSION METHOD ***" << endl;
+    cout << "1. Gradient Descent (Better for large datasets)" << endl;
+    cout << "2. Least Squares (Faster for small datasets)" << endl;
+    cout << "Enter choice (1 or 2): ";
+    
+    string modelChoice;
+    cin >> modelChoice;
+    
+    if (modelChoice == "1") {
+        double lr_rate;
+        int max_iter;
+        
+        // Get learning rate with validation
+        cout << "Enter learning rate (0.001 to 1.0, default 0.01): ";
+        cin >> lr_rate;
+        
+        if (lr_rate <= 0 || lr_rate > 1.0) {
+            cout << "*** WARNING: Invalid learning rate. Using default 0.01" << endl;
+            lr_rate = 0.01;
+        }
+        
+        cout << "Enter max iterations (100 to 100000, default 1000): ";
+        cin >> max_iter;
+        
+        if (max_iter < 100 || max_iter > 100000) {
+            cout << "*** WARNING: Invalid iterations. Using default 1000" << endl;
+            max_iter = 1000;
+        }
+        
+        // Standardize so data in the thousands (e.g. house sizes) does not
+        // diverge at these learning rates
+        GradientDescentOptions options;
+        options.learning_rate = lr_rate;
+        options.max_iterations = max_iter;
+        options.threads = 0;
+        options.standardize = true;
+        lr.useGradientDescent(options);
+        cout << "*** SUCCESS: Using Gradient Descent" << endl;
+        cout << "*** INFO: x and y are standardized, so the learning rate applies to the scaled data;" << endl;
+        cout << "*** INFO: gradients use " << resolveThreadCount(options.threads) << " thread(s)."
+             << " Use the 'train' command to change either." << endl;
+    } else if (modelChoice == "2") {
+        lr.useLeastSquares();
+        cout << "*** SUCCESS: Using Least Squares" << endl;
+    } else {
+        cout << "*** WARNING: Invalid choice. Using Least Squares by default." << endl;
+        lr.useLeastSquares();
+    }
+    
+    // Step 6: Train Model
+    try {
+        cout << "\n*** TRAINING MODEL ***" << endl;
+        lr.trainModel();
+        cout << "*** SUCCESS: Model trained successfully!" << endl;
+        lr.displayResults();
+        lr.displayEvaluation();
+    } catch (const exception& e) {
+        cout << "*** ERROR Training failed: " << e.what() << endl;
+        return;
+    }
+    
+    // Step 7: Prediction Loop
+    auto prompts = getCategoryPrompts(categoryId);
+    string inputPrompt = prompts.first;
+    string outputLabel = prompts.second;
+    
+    cout << "\n*** PREDICTION MODE ***" << endl;
+    cout << "=======================" << endl;
+    cout << "I can predict " << outputLabel << " based on " << inputPrompt << endl;
+    cout << "*** WARNING: Predictions are most accurate within the training data range ***" << endl;
+    cout << "Enter -1 to exit prediction mode" << endl;
+    
+    while (true) {
+        double inputValue;
+        
+        cout << "\nEnter " << inputPrompt << " (or -1 to exit): ";
+        cin >> inputValue;
+        
+        if (inputValue == -1) {
+            break;
+        }
+        
+        try {
+            double prediction = lr.predict(inputValue);
+            cout << "*** PREDICTION RESULT ***" << endl;
+            cout << "For " << inputPrompt << ": " << inputValue << endl;
+            cout << "Predicted " << outputLabel << ": " << prediction << endl;
+            
+            // Add category-specific validation
+            if (categoryId == "1") { // Education
+                if (prediction > 100) {
+                    cout << "*** WARNING: Predicted score exceeds 100 marks!" << endl;
+                    cout << "*** REALISTIC ESTIMATE: Maximum possible score is ~100" << endl;
+                }
+                
+                if (prediction >= 90) cout << "*** ANALYSIS: Excellent score!" << endl;
+                else if (prediction >= 75) cout << "*** ANALYSIS: Good score!" << endl;
+                else if (prediction >= 60) cout << "*** ANALYSIS: Average score" << endl;
+                else cout << "*** ANALYSIS: Needs improvement" << endl;
+            }
+            else if (categoryId == "2") { // Real Estate
+                if (prediction < 0) {
+                    cout << "*** WARNING: Negative price predicted!" << endl;
+                    cout << "*** REALISTIC ESTIMATE: Minimum price should be > 0" << endl;
+                }
+                cout << "*** ANALYSIS: Estimated property value" << endl;
+            }
+            else if (categoryId == "3") { // Business
+                if (prediction < 0) {
+                    cout << "*** WARNING: Negative sales predicted!" << endl;
+                }
+                cout << "*** ANALYSIS: Expected sales revenue" << endl;
+            }
+            else if (categoryId == "4") { // Healthcare
+                if (prediction > 100) {
+                    cout << "*** WARNING: Recovery rate exceeds 100%!" << endl;
+                }
+                if (prediction >= 80) cout << "*** ANALYSIS: High recovery rate!" << endl;
+                else if (prediction >= 60) cout << "*** ANALYSIS: Good recovery rate" << endl;
+                else cout << "*** ANALYSIS: Continuing treatment needed" << endl;
+            }
+            else if (categoryId == "5") { // Sports
+                if (prediction > 100) {
+                    cout << "*** WARNING: Performance score exceeds 100!" << endl;
+                }
+                if (prediction >= 90) cout << "*** ANALYSIS: Elite performance!" << endl;
+                else if (prediction >= 80) cout << "*** ANALYSIS: Great performance!" << endl;
+                else if (prediction >= 70) cout << "*** ANALYSIS: Good performance" << endl;
+                else cout << "*** ANALYSIS: Keep training!" << endl;
+            }
+            else if (categoryId == "6") { // Salary
+                if (prediction < 0) {
+                    cout << "*** WARNING: Negative salary predicted!" << endl;
+                }
+                cout << "*** ANALYSIS: Estimated annual salary" << endl;
+            }
+            else if (categoryId == "7") { // Temperature
+                cout << "*** ANALYSIS: Expected ice cream sales" << endl;
+            }
+            else if (categoryId == "8") { // Car valuation
+                if (prediction < 0) {
+                    cout << "*** WARNING: Negative car price predicted!" << endl;
+                }
+                cout << "*** ANALYSIS: Estimated car value" << endl;
+            }
+            else { // Custom
+                cout << "*** ANALYSIS: Predicted output based on input" << endl;
+            }
+            
+        } catch (const exception& e) {
+            cout << "*** ERROR Prediction error: " << e.what() << endl;
+        }
+    }
+    
+    cout << "\n*** Thank you for using Linear Regression Predictor!" << endl;
+    cout << "*** Category: " << currentCategory << endl;
+}
+
+// Exit codes shared by the command-line subcommands
+const int EXIT_CODE_OK = 0;
+const int EXIT_CODE_FAILED = 1;  // bad input data, I/O or training failure
+const int EXIT_CODE_USAGE = 2;   // unknown command or invalid arguments
+
+// A fit that overflowed has NaN/inf parameters, and NaN comparisons leave
+// the error metrics at 0; report it as a training failure instead
+void requireFiniteFit(double slope, double intercept, double mse) {
+    if (!isfinite(slope) || !isfinite(intercept) || !isfinite(mse)) {
+        throw runtime_error("Training produced a non-finite fit (slope " + to_string(slope) +
+                            ", intercept " + to_string(intercept) + ", MSE " + to_string(mse) + ")");
+    }
+}
+
+// Fit least squares on a CSV file or stdin ("-") in one pass and O(1) memory
+int runStreamingTrainer(const string& source) {
+    StreamingLeastSquaresModel model;
+    
+    try {
+        if (source == "-") {
+            ios::sync_with_stdio(false);
+            model.trainFromStream(cin);
+        } else {
+            model.trainFromFile(source);
+        }
+        requireFiniteFit(model.getSlope(), model.getIntercept(), model.getMSE());
+    } catch (const exception& e) {
+        cerr << "*** ERROR Streaming training failed: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+    
+    cout << "*** STREAMED " << model.getCount() << " rows ("
+         << model.getYLabel() << " vs " << model.getXLabel() << ")" << endl;
+    model.displayResults();
+    return EXIT_CODE_OK;
+}
+
+// Write the .lrbin cache for a CSV file (default: next to the CSV)
+int runBinaryConverter(const string& csv_filename, const string& binary_filename) {
+    try {
+        auto start_time = chrono::steady_clock::now();
+        convertCSVToBinary(csv_filename, binary_filename);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        cout << "*** SUCCESS: Wrote " << binary_filename << " in " << seconds << " s" << endl;
+    } catch (const exception& e) {
+        cerr << "*** ERROR Conversion failed: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+    return EXIT_CODE_OK;
+}
+
+// Train least squares on training_file, then score every x in input_file
+// ("-" = stdin) into output_file ("-" = stdout)
+int runBulkScoring(const string& training_file, const string& input_file, const string& output_file) {
+    ios::sync_with_stdio(false);
+    LinearRegression lr;
+    
+    try {
+        lr.loadData(training_file, 0);
+        lr.setVerbose(false);
+        lr.useLeastSquares();
+        lr.trainModel();
+        requireFiniteFit(lr.getModel().getSlope(), lr.getModel().getIntercept(), lr.getModel().getMSE());
+    } catch (const exception& e) {
+        cerr << "*** ERROR Training failed: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+    
+    ifstream input_stream;
+    ofstream output_stream;
+    if (input_file != "-") {
+        input_stream.open(input_file, ios::binary);
+        if (!input_stream.is_open()) {
+            cerr << "*** ERROR: Cannot open file: " << input_file << endl;
+            return EXIT_CODE_FAILED;
+        }
+    }
+    if (output_file != "-") {
+        output_stream.open(output_file, ios::binary | ios::trunc);
+        if (!output_stream.is_open()) {
+            cerr << "*** ERROR: Cannot create file: " << output_file << endl;
+            return EXIT_CODE_FAILED;
+        }
+    }
+    
+    istream& input = (input_file == "-") ? cin : input_stream;
+    ostream& output = (output_file == "-") ? cout : output_stream;
+    
+    auto start_time = chrono::steady_clock::now();
+    size_t rows = scoreCSVStream(lr, input, output);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    
+    if (!output) {
+        cerr << "*** ERROR: Failed writing predictions" << endl;
+        return EXIT_CODE_FAILED;
+    }
+    cerr << "*** SCORED " << rows << " rows in " << seconds << " s ("
+         << (rows > 0 ? seconds * 1e9 / rows : 0.0) << " ns/prediction)" << endl;
+    return EXIT_CODE_OK;
+}
+
+// Fit a multi-feature model on a CSV whose last column is the target
+int runMultipleRegression(const string& filename) {
+    LinearRegression lr;
+    
+    try {
+        lr.loadMultipleData(filename);
+        lr.displayMultipleDatasetSummary();
+        lr.useMultipleRegression();
+        lr.trainMultipleModel();
+        lr.displayMultipleResults();
+    } catch (const exception& e) {
+        cerr << "*** ERROR Multiple regression failed: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+    return EXIT_CODE_OK;
+}
+
+// Shell-style match of '*' and '?' against a file name
+bool matchesWildcard(const string& pattern, const string& name) {
+    size_t p = 0, n = 0;
+    size_t star = string::npos, resume = 0;
+    
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = n;
+        } else if (star != string::npos) {
+            p = star + 1;
+            n = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+// Expand batch arguments into CSV files: a directory gives its *.csv files,
+// a pattern with '*' or '?' matches file names in its directory, "@list"
+// reads one path per line, anything else is taken as a file
+void collectBatchFiles(const string& argument, vector<string>& files) {
+    namespace fs = std::filesystem;
+    
+    if (!argument.empty() && argument[0] == '@') {
+        ifstream list(argument.substr(1));
+        if (!list.is_open()) {
+            throw runtime_error("Cannot open file: " + argument.substr(1));
+        }
+        string line;
+        while (getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty()) {
+                collectBatchFiles(line, files);
+            }
+        }
+        return;
+    }
+    
+    if (argument.find_first_of("*?") != string::npos) {
+        fs::path pattern(argument);
+        fs::path directory = pattern.has_parent_path() ? pattern.parent_path() : fs::path(".");
+        string name_pattern = pattern.filename().string();
+        vector<string> matches;
+        for (const auto& entry : fs::directory_iterator(directory)) {
+            if (entry.is_regular_file() && matchesWildcard(name_pattern, entry.path().filename().string())) {
+                matches.push_back(pattern.has_parent_path() ? entry.path().string()
+                                                            : entry.path().filename().string());
+            }
+        }
+        sort(matches.begin(), matches.end());
+        files.insert(files.end(), matches.begin(), matches.end());
+        return;
+    }
+    
+    if (fs::is_directory(argument)) {
+        vector<string> matches;
+        for (const auto& entry : fs::directory_iterator(argument)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+                matches.push_back(entry.path().string());
+            }
+        }
+        sort(matches.begin(), matches.end());
+        files.insert(files.end(), matches.begin(), matches.end());
+        return;
+    }
+    
+    files.push_back(argument);
+}
+
+struct BatchResult {
+    string filename;
+    uintmax_t bytes = 0;
+    size_t rows = 0;
+    double slope = 0.0;
+    double intercept = 0.0;
+    double mse = 0.0;
+    double r_squared = 0.0;
+    double load_seconds = 0.0;
+    double train_seconds = 0.0;
+    string error;
+};
+
+// Quote a CSV field when it contains a separator, quote or line break
+string quoteCSVField(const string& field) {
+    if (field.find_first_of(",\"\r\n") == string::npos) {
+        return field;
+    }
+    string quoted = "\"";
+    for (char c : field) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Load and fit least squares on one file; failures are recorded, not thrown
+void trainBatchFile(BatchResult& result) {
+    try {
+        LinearRegression lr;
+        lr.setVerbose(false);
+        
+        auto start_time = chrono::steady_clock::now();
+        lr.loadData(result.filename);
+        auto loaded_time = chrono::steady_clock::now();
+        lr.useLeastSquares();
+        lr.trainModel();
+        auto trained_time = chrono::steady_clock::now();
+        
+        const RegressionModel& model = lr.getModel();
+        result.rows = lr.getDataset().getSize();
+        result.slope = model.getSlope();
+        result.intercept = model.getIntercept();
+        result.mse = model.getMSE();
+        result.r_squared = model.getRSquared();
+        requireFiniteFit(result.slope, result.intercept, result.mse);
+        result.load_seconds = chrono::duration<double>(loaded_time - start_time).count();
+        result.train_seconds = chrono::duration<double>(trained_time - loaded_time).count();
+    } catch (const exception& e) {
+        result.error = e.what();
+    }
+}
+
+// Train every file concurrently, largest first, and write one results table
+// (CSV to results_file, or an aligned table to stdout when it is empty)
+int runBatchTraining(const vector<string>& arguments, unsigned num_threads, const string& results_file) {
+    vector<BatchResult> results;
+    try {
+        vector<string> files;
+        for (const auto& argument : arguments) {
+            collectBatchFiles(argument, files);
+        }
+        for (const auto& file : files) {
+            BatchResult result;
+            result.filename = file;
+            error_code ec;
+            result.bytes = std::filesystem::file_size(file, ec);
+            results.push_back(result);
+        }
+    } catch (const exception& e) {
+        cerr << "*** ERROR: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+    
+    if (results.empty()) {
+        cerr << "*** ERROR: No CSV files to train" << endl;
+        return EXIT_CODE_FAILED;
+    }
+    
+    vector<size_t> order(results.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return results[a].bytes > results[b].bytes;
+    });
+    
+    auto start_time = chrono::steady_clock::now();
+    ThreadPool pool(min<size_t>(resolveThreadCount(num_threads), results.size()));
+    WorkStealingScheduler scheduler(pool);
+    scheduler.run(order, [&](size_t task) { trainBatchFile(results[task]); });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    
+    size_t failed = 0;
+    size_t total_rows = 0;
+    for (const auto& result : results) {
+        failed += result.error.empty() ? 0 : 1;
+        total_rows += result.rows;
+    }
+    
+    if (!results_file.empty()) {
+        ofstream out(results_file, ios::trunc);
+        if (!out.is_open()) {
+            cerr << "*** ERROR: Cannot create file: " << results_file << endl;
+            return EXIT_CODE_FAILED;
+        }
+        out << setprecision(10);
+        out << "file,rows,slope,intercept,mse,r_squared,load_ms,train_ms,status\n";
+        for (const auto& r : results) {
+            out << quoteCSVField(r.filename) << ',' << r.rows << ',' << r.slope << ',' << r.intercept << ','
+                << r.mse << ',' << r.r_squared << ',' << r.load_seconds * 1e3 << ','
+                << r.train_seconds * 1e3 << ',' << (r.error.empty() ? "ok" : quoteCSVField(r.error)) << '\n';
+        }
+        if (!out) {
+            cerr << "*** ERROR: Failed writing " << results_file << endl;
+            return EXIT_CODE_FAILED;
+        }
     } else {
-        // If no datasets created, ask for file path
-        cout << "\n*** ENTER CSV FILE PATH ***" << endl;
-        displayDatasetSuggestions(categoryId);
+        size_t name_width = 4;
+        for (const auto& r : results) {
+            name_width = max(name_width, r.filename.size());
+        }
+        cout << left << setw(name_width) << "File" << right
+             << setw(12) << "Rows" << setw(14) << "Slope" << setw(14) << "Intercept"
+             << setw(12) << "R-squared" << setw(11) << "Load ms" << setw(11) << "Train ms"
+             << "  Status" << endl;
+        cout << fixed;
+        for (const auto& r : results) {
+            cout << left << setw(name_width) << r.filename << right << setw(12) << r.rows
+                 << setprecision(4) << setw(14) << r.slope << setw(14) << r.intercept
+                 << setw(12) << r.r_squared << setprecision(2)
+                 << setw(11) << r.load_seconds * 1e3 << setw(11) << r.train_seconds * 1e3
+                 << "  " << (r.error.empty() ? "ok" : r.error) << endl;
+        }
+        cout.unsetf(ios::floatfield);
+    }
+    
+    cerr << "*** BATCH " << results.size() << " files, " << total_rows << " rows, "
+         << failed << " failed, " << pool.size() << " threads, " << seconds << " s" << endl;
+    return failed == 0 ? EXIT_CODE_OK : EXIT_CODE_FAILED;
+}
+
+// batch [--threads N] [--output results.csv] <file|dir|pattern|@list>...
+int runBatchCommand(int argc, char* argv[]) {
+    unsigned num_threads = 0;
+    string results_file;
+    vector<string> arguments;
+    
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            try {
+                num_threads = static_cast<unsigned>(stoul(argv[++i]));
+            } catch (const exception&) {
+                cerr << "*** ERROR: Invalid thread count: " << argv[i] << endl;
+                return EXIT_CODE_USAGE;
+            }
+        } else if (arg == "--output" && i + 1 < argc) {
+            results_file = argv[++i];
+        } else {
+            arguments.push_back(arg);
+        }
+    }
+    
+    if (arguments.empty()) {
+        cerr << "Usage: " << argv[0] << " batch [--threads N] [--output results.csv] <file|dir|pattern|@list>..." << endl;
+        return EXIT_CODE_USAGE;
+    }
+    return runBatchTraining(arguments, num_threads, results_file);
+}
+
+// Parse a whole argument as a number; false on trailing characters
+template <typename T>
+bool parseArgument(const string& text, T& value) {
+    const char* end = text.data() + text.size();
+    auto result = from_chars(text.data(), end, value);
+    return !text.empty() && result.ec == errc() && result.ptr == end;
+}
+
+string escapeJSON(const string& text) {
+    string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void printUsage(ostream& out, const char* program) {
+    out << "Usage: " << program << " <command> [arguments]\n"
+        << "\n"
+        << "Commands:\n"
+        << "  train <data.csv> [options]     Fit a model and report or apply it\n"
+        << "  batch [--threads N] [--output results.csv] <file|dir|pattern|@list>...\n"
+        << "  stream <data.csv|->            One-pass least squares in O(1) memory\n"
+        << "  score <train.csv> <in|-> <out|->  Bulk predictions for x values\n"
+        << "  convert <data.csv> [out.lrbin] Write the binary dataset cache\n"
+        << "  multi <data.csv>               Multiple regression, last column is the target\n"
+        << "  predict <model.lrmodel> <in|-> <out|->  Score x values with a saved model\n"
+        << "  export <model.lrmodel> [out.txt|-]      Saved model as readable text\n"
+        << "  serve [--port P] [--method M] <data.csv|model.lrmodel>...  Prediction server on 127.0.0.1\n"
+        << "  loadgen [--port P] [--model ID] [--requests N] [--batch B] [--pipeline D]\n"
+        << "  generate <out.csv> [--rows N] [--slope S] [--intercept B] [--x-range MIN,MAX]\n"
+        << "           [--noise gaussian|uniform|laplace|cauchy] [--noise-scale S] [--outliers RATE]\n"
+        << "           [--outlier-scale S] [--seed N] [--threads N] [--labels X,Y] [--binary [out.lrbin]]\n"
+        << "                                 Deterministic synthetic data of any size\n"
+        << "  bench [--sizes N,...] [--max-rows N] [--repeat R] [--output file.json] [--precision P]\n"
+        << "                                 Ingestion, training, MSE and prediction benchmarks\n"
+        << "  interactive                    Menu-driven workflow (default with no command)\n"
+        << "  help                           Show this message\n"
+        << "\n"
+        << "train options:\n"
+        << "  --method ls|gd|sgd|online|window|decay   (default ls)\n"
+        << "  --learning-rate R  --iterations N  --tolerance T\n"
+        << "  --optimizer plain|momentum|nesterov|adam|armijo  --momentum B (0 <= B < 1)\n"
+        << "  --gradient fullpass|moments  --no-standardize  --threads N (0 = all cores)\n"
+        << "  --precision double|float32    Dataset storage; float32 halves memory, values keep\n"
+        << "                                ~7 significant digits, sums stay double (default double)\n"
+        << "  --batch-size N  --seed S      (sgd; --iterations is the epoch count, the learning\n"
+        << "                                rate defaults to 0.1 and decays as 1 / (1 + 0.05 epoch))\n"
+        << "  --window N                    (window, default 1000)\n"
+        << "  --decay F                     (decay forgetting factor, default 0.999)\n"
+        << "  --format text|json|csv        Summary format (default text)\n"
+        << "  --predict <x.csv|->           Score x values with the fitted model\n"
+        << "  --output <file|->             Where predictions go (default stdout)\n"
+        << "  --save-model <file.lrmodel>   Save the fitted model for 'predict' and 'serve'\n"
+        << "  --trace <file.csv>            Gradient descent convergence trace\n"
+        << "  --trace-every K  --trace-capacity N  (defaults 1 and 4096, newest samples kept)\n"
+        << "\n"
+        << "Any command: --metrics json|prometheus [--metrics-file F]  phase timings and counters\n"
+        << "             (written to stderr by default; --metrics-file alone means json)\n"
+        << "\n"
+        << "Exit codes: 0 success, 1 data/training failure, 2 usage error\n";
+}
+
+struct TrainCommandOptions {
+    string data_file;
+    string method = "ls";
+    GradientDescentOptions gradient;
+    bool learning_rate_set = false;  // otherwise sgd uses its own default
+    int iterations = -1;  // -1 = method default
+    size_t batch_size = 256;
+    uint64_t seed = 42;
+    size_t window = 1000;
+    double decay = 0.999;
+    string format = "text";
+    string predict_file;
+    string output_file = "-";
+    string model_file;  // --save-model
+    string trace_file;  // --trace
+    StoragePrecision precision = StoragePrecision::Double;
+};
+
+// Fill options from argv[2..]; prints the problem and returns false on error
+bool parseTrainArguments(int argc, char* argv[], TrainCommandOptions& options) {
+    options.gradient.threads = 0;
+    options.gradient.standardize = true;
+    
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        string value = has_value ? argv[i + 1] : "";
+        bool valid = true;
         
-        // Suggest the default file for this category
-        cout << "Suggested file: " << defaultFiles[categoryId] << endl;
-        cout << "Enter the path to your CSV file: ";
-        cin >> filepath;
+        if (arg == "--no-standardize") {
+            options.gradient.standardize = false;
+            continue;
+        }
+        if (arg.size() < 2 || arg.compare(0, 2, "--") != 0) {
+            if (!options.data_file.empty()) {
+                cerr << "*** ERROR: Unexpected argument: " << arg << "\n";
+                return false;
+            }
+            options.data_file = arg;
+            continue;
+        }
+        if (!has_value) {
+            cerr << "*** ERROR: Missing value for " << arg << "\n";
+            return false;
+        }
+        ++i;
         
-        // If file doesn't exist, offer to create sample
-        if (!fileExists(filepath)) {
-            cout << "*** ERROR: File not found: " << filepath << endl;
-            cout << "Would you like to create a sample dataset? (y/n): ";
-            char choice;
-            cin >> choice;
+        if (arg == "--method") {
+            options.method = value;
+            valid = value == "ls" || value == "gd" || value == "sgd" || value == "online" ||
+                    value == "window" || value == "decay";
+        } else if (arg == "--learning-rate") {
+            valid = parseArgument(value, options.gradient.learning_rate) && options.gradient.learning_rate > 0;
+            options.learning_rate_set = true;
+        } else if (arg == "--iterations") {
+            valid = parseArgument(value, options.iterations) && options.iterations > 0;
+        } else if (arg == "--tolerance") {
+            valid = parseArgument(value, options.gradient.tolerance) && options.gradient.tolerance >= 0;
+        } else if (arg == "--momentum") {
+            valid = parseArgument(value, options.gradient.momentum) &&
+                    options.gradient.momentum >= 0 && options.gradient.momentum < 1;
+        } else if (arg == "--threads") {
+            valid = parseArgument(value, options.gradient.threads);
+        } else if (arg == "--optimizer") {
+            static const map<string, Optimizer> optimizers = {
+                {"plain", Optimizer::Plain}, {"momentum", Optimizer::Momentum},
+                {"nesterov", Optimizer::Nesterov}, {"adam", Optimizer::Adam},
+                {"armijo", Optimizer::Armijo}
+            };
+            auto found = optimizers.find(value);
+            valid = found != optimizers.end();
+            if (valid) {
+                options.gradient.optimizer = found->second;
+            }
+        } else if (arg == "--gradient") {
+            valid = value == "fullpass" || value == "moments";
+            options.gradient.mode = value == "moments" ? GradientMode::Moments : GradientMode::FullPass;
+        } else if (arg == "--batch-size") {
+            valid = parseArgument(value, options.batch_size) && options.batch_size > 0;
+        } else if (arg == "--seed") {
+            valid = parseArgument(value, options.seed);
+        } else if (arg == "--window") {
+            valid = parseArgument(value, options.window) && options.window >= 2;
+        } else if (arg == "--decay") {
+            valid = parseArgument(value, options.decay) && options.decay > 0 && options.decay <= 1;
+        } else if (arg == "--precision") {
+            valid = parseStoragePrecision(value, options.precision);
+        } else if (arg == "--format") {
+            options.format = value;
+            valid = value == "text" || value == "json" || value == "csv";
+        } else if (arg == "--predict") {
+            options.predict_file = value;
+        } else if (arg == "--output") {
+            options.output_file = value;
+        } else if (arg == "--save-model") {
+            options.model_file = value;
+        } else if (arg == "--trace") {
+            options.trace_file = value;
+            if (options.gradient.trace_capacity == 0) {
+                options.gradient.trace_capacity = 4096;
+            }
+        } else if (arg == "--trace-every") {
+            valid = parseArgument(value, options.gradient.trace_every) && options.gradient.trace_every > 0;
+        } else if (arg == "--trace-capacity") {
+            valid = parseArgument(value, options.gradient.trace_capacity) && options.gradient.trace_capacity > 0;
+        } else {
+            cerr << "*** ERROR: Unknown option: " << arg << "\n";
+            return false;
+        }
+        
+        if (!valid) {
+            cerr << "*** ERROR: Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+    
+    if (options.data_file.empty()) {
+        cerr << "*** ERROR: No training file given\n";
+        return false;
+    }
+    if (!options.trace_file.empty() && options.method != "gd") {
+        cerr << "*** ERROR: --trace needs --method gd\n";
+        return false;
+    }
+    return true;
+}
+
+void selectTrainMethod(LinearRegression& lr, const TrainCommandOptions& options) {
+    if (options.method == "gd") {
+        GradientDescentOptions gradient = options.gradient;
+        if (options.iterations > 0) {
+            gradient.max_iterations = options.iterations;
+        }
+        lr.useGradientDescent(gradient);
+    } else if (options.method == "sgd") {
+        lr.useMiniBatchGradientDescent(options.learning_rate_set ? options.gradient.learning_rate
+                                                                 : MiniBatchGradientDescentModel::DEFAULT_LEARNING_RATE,
+                                       options.iterations > 0 ? options.iterations : 100,
+                                       options.batch_size, options.gradient.tolerance, options.seed,
+                                       options.gradient.standardize);
+    } else if (options.method == "online") {
+        lr.useOnlineLeastSquares();
+    } else if (options.method == "window") {
+        lr.useSlidingWindow(options.window);
+    } else if (options.method == "decay") {
+        lr.useExponentialDecay(options.decay);
+    } else {
+        lr.useLeastSquares();
+    }
+}
+
+void writeTrainSummary(ostream& out, const TrainCommandOptions& options, const LinearRegression& lr,
+                       const RegressionMetrics& metrics, double load_seconds, double train_seconds) {
+    const RegressionModel& model = lr.getModel();
+    const Dataset& dataset = lr.getDataset();
+    out << setprecision(10);
+    
+    if (options.format == "json") {
+        out << "{\"file\": \"" << escapeJSON(options.data_file) << "\", "
+            << "\"method\": \"" << options.method << "\", "
+            << "\"x_label\": \"" << escapeJSON(dataset.getXLabel()) << "\", "
+            << "\"y_label\": \"" << escapeJSON(dataset.getYLabel()) << "\", "
+            << "\"rows\": " << dataset.getSize() << ", "
+            << "\"precision\": \"" << storagePrecisionName(dataset.getStoragePrecision()) << "\", "
+            << "\"slope\": " << model.getSlope() << ", "
+            << "\"intercept\": " << model.getIntercept() << ", "
+            << "\"mse\": " << metrics.mse << ", "
+            << "\"rmse\": " << metrics.rmse << ", "
+            << "\"mae\": " << metrics.mae << ", "
+            << "\"r_squared\": " << metrics.r_squared << ", "
+            << "\"max_error\": " << metrics.max_error << ", "
+            << "\"metrics_rows\": " << metrics.count << ", "
+            << "\"load_seconds\": " << load_seconds << ", "
+            << "\"train_seconds\": " << train_seconds << "}\n";
+    } else if (options.format == "csv") {
+        out << "file,method,rows,slope,intercept,mse,rmse,mae,r_squared,max_error,metrics_rows,"
+            << "load_seconds,train_seconds\n"
+            << quoteCSVField(options.data_file) << ',' << options.method << ',' << dataset.getSize() << ','
+            << model.getSlope() << ',' << model.getIntercept() << ',' << metrics.mse << ','
+            << metrics.rmse << ',' << metrics.mae << ',' << metrics.r_squared << ','
+            << metrics.max_error << ',' << metrics.count << ',' << load_seconds << ',' << train_seconds << '\n';
+    } else {
+        out << "File: " << options.data_file << " (" << dataset.getSize() << " rows, "
+            << dataset.getYLabel() << " vs " << dataset.getXLabel() << ", "
+            << storagePrecisionName(dataset.getStoragePrecision()) << ")\n"
+            << "Method: " << options.method << "\n"
+            << "Equation: y = " << model.getSlope() << " * x + " << model.getIntercept() << "\n";
+        if (dynamic_cast<const SlidingWindowModel*>(&model)) {
+            out << "Metrics: last " << metrics.count << " rows (the window)\n";
+        } else if (auto decayed = dynamic_cast<const DecayedRegressionModel*>(&model)) {
+            out << "Metrics: decay-weighted over " << metrics.count << " rows, max error over the last "
+                << decayed->getEffectiveMemory() << "\n";
+        }
+        out << "MSE: " << metrics.mse << "\n"
+            << "RMSE: " << metrics.rmse << "\n"
+            << "MAE: " << metrics.mae << "\n"
+            << "R-squared: " << metrics.r_squared << "\n"
+            << "Max Error: " << metrics.max_error << "\n"
+            << "Load: " << load_seconds << " s, train: " << train_seconds << " s\n";
+    }
+}
+
+// Dump the gradient descent convergence trace as CSV
+void writeTrainTrace(const LinearRegression& lr, const string& filename) {
+    const GradientDescentModel* gd = dynamic_cast<const GradientDescentModel*>(&lr.getModel());
+    if (!gd) {
+        throw runtime_error("--trace needs --method gd");
+    }
+    
+    ofstream out(filename, ios::trunc);
+    if (!out.is_open()) {
+        throw runtime_error("Cannot create file: " + filename);
+    }
+    gd->getTrace().writeCSV(out);
+    if (!out) {
+        throw runtime_error("Failed writing file: " + filename);
+    }
+    cerr << "*** TRACE " << gd->getTrace().size() << " of " << gd->getTrace().getRecorded()
+         << " samples to " << filename << "; " << gd->getIterations() << " iterations, "
+         << (gd->hasConverged() ? "converged within tolerance" : "max_iterations reached") << "\n";
+}
+
+// Non-interactive training: every choice comes from the command line, the
+// summary goes to stdout (stderr when predictions are written to stdout)
+int runTrainCommand(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    
+    TrainCommandOptions options;
+    if (!parseTrainArguments(argc, argv, options)) {
+        cerr << "Run '" << argv[0] << " help' for usage.\n";
+        return EXIT_CODE_USAGE;
+    }
+    
+    LinearRegression lr;
+    lr.setVerbose(false);
+    lr.setStoragePrecision(options.precision);
+    RegressionMetrics metrics;
+    double load_seconds = 0.0;
+    double train_seconds = 0.0;
+    
+    try {
+        auto start_time = chrono::steady_clock::now();
+        lr.loadData(options.data_file, options.gradient.threads);
+        auto loaded_time = chrono::steady_clock::now();
+        selectTrainMethod(lr, options);
+        lr.trainModel();
+        auto trained_time = chrono::steady_clock::now();
+        
+        metrics = lr.evaluateModel();
+        requireFiniteFit(lr.getModel().getSlope(), lr.getModel().getIntercept(), metrics.mse);
+        load_seconds = chrono::duration<double>(loaded_time - start_time).count();
+        train_seconds = chrono::duration<double>(trained_time - loaded_time).count();
+        
+        if (!options.model_file.empty()) {
+            lr.saveModel(options.model_file);
+        }
+        if (!options.trace_file.empty()) {
+            writeTrainTrace(lr, options.trace_file);
+        }
+    } catch (const exception& e) {
+        cerr << "*** ERROR: " << e.what() << "\n";
+        return EXIT_CODE_FAILED;
+    }
+    
+    bool predictions_to_stdout = !options.predict_file.empty() && options.output_file == "-";
+    writeTrainSummary(predictions_to_stdout ? cerr : cout, options, lr, metrics, load_seconds, train_seconds);
+    
+    if (options.predict_file.empty()) {
+        cout.flush();
+        return cout ? EXIT_CODE_OK : EXIT_CODE_FAILED;
+    }
+    
+    ifstream input_stream;
+    ofstream output_stream;
+    if (options.predict_file != "-") {
+        input_stream.open(options.predict_file, ios::binary);
+        if (!input_stream.is_open()) {
+            cerr << "*** ERROR: Cannot open file: " << options.predict_file << "\n";
+            return EXIT_CODE_FAILED;
+        }
+    }
+    if (options.output_file != "-") {
+        output_stream.open(options.output_file, ios::binary | ios::trunc);
+        if (!output_stream.is_open()) {
+            cerr << "*** ERROR: Cannot create file: " << options.output_file << "\n";
+            return EXIT_CODE_FAILED;
+        }
+    }
+    
+    istream& input = options.predict_file == "-" ? cin : input_stream;
+    ostream& output = options.output_file == "-" ? cout : static_cast<ostream&>(output_stream);
+    scoreCSVStream(lr, input, output);
+    output.flush();
+    
+    if (!output) {
+        cerr << "*** ERROR: Failed writing predictions\n";
+        return EXIT_CODE_FAILED;
+    }
+    return EXIT_CODE_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Prediction server
+//
+// Binary protocol over localhost TCP, all integers and doubles in native
+// byte order (little-endian on every supported platform):
+//   request:  uint32 model_id, uint32 count, count x double
+//   response: uint32 status,   uint32 count, count x double predictions
+// A single prediction is a request with count = 1. Clients may pipeline:
+// requests are answered strictly in order, and every complete request in
+// one read is answered with one write.
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+typedef SOCKET SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+inline void closeSocket(SocketHandle socket_handle) { closesocket(socket_handle); }
+const int SEND_FLAGS = 0;
+#else
+typedef int SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = -1;
+inline void closeSocket(SocketHandle socket_handle) { close(socket_handle); }
+const int SEND_FLAGS = MSG_NOSIGNAL;
+#endif
+
+// Starts and stops Winsock; nothing to do elsewhere
+class SocketLibrary {
+public:
+    SocketLibrary() {
+#ifdef _WIN32
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            throw runtime_error("Cannot initialise Winsock");
+        }
+#endif
+    }
+    
+    ~SocketLibrary() {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+    
+    SocketLibrary(const SocketLibrary&) = delete;
+    SocketLibrary& operator=(const SocketLibrary&) = delete;
+};
+
+struct PredictionHeader {
+    uint32_t id_or_status;
+    uint32_t count;
+};
+
+enum PredictionStatus : uint32_t {
+    PREDICTION_OK = 0,
+    PREDICTION_UNKNOWN_MODEL = 1,
+    PREDICTION_TOO_LARGE = 2
+};
+
+const uint32_t MAX_PREDICTIONS_PER_REQUEST = 1 << 20;
+
+bool sendAll(SocketHandle socket_handle, const char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(min<size_t>(size, 1 << 30));
+        int sent = send(socket_handle, data, chunk, SEND_FLAGS);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool receiveAll(SocketHandle socket_handle, char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(min<size_t>(size, 1 << 30));
+        int received = recv(socket_handle, data, chunk, 0);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+void disableNagle(SocketHandle socket_handle) {
+    int enabled = 1;
+    setsockopt(socket_handle, IPPROTO_TCP, TCP_NODELAY,
+               reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+}
+
+sockaddr_in loopbackAddress(uint16_t port) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+// Answer requests on one connection until the client closes it
+void servePredictionConnection(SocketHandle client, const vector<unique_ptr<LinearRegression>>& models) {
+    vector<char> input(1 << 16);
+    size_t filled = 0;
+    vector<char> output;
+    vector<double> values;
+    vector<double> predictions;
+    
+    while (true) {
+        if (filled == input.size()) {
+            input.resize(input.size() * 2);
+        }
+        int received = recv(client, input.data() + filled, static_cast<int>(input.size() - filled), 0);
+        if (received <= 0) {
+            break;
+        }
+        filled += static_cast<size_t>(received);
+        
+        // Answer every complete request in the buffer with one write
+        size_t consumed = 0;
+        output.clear();
+        bool close_connection = false;
+        while (filled - consumed >= sizeof(PredictionHeader)) {
+            PredictionHeader request;
+            memcpy(&request, input.data() + consumed, sizeof(request));
             
-            if (choice == 'y' || choice == 'Y') {
-                createSampleCSV(categoryId, filepath);
+            if (request.count > MAX_PREDICTIONS_PER_REQUEST) {
+                PredictionHeader response = {PREDICTION_TOO_LARGE, 0};
+                output.insert(output.end(), reinterpret_cast<const char*>(&response),
+                              reinterpret_cast<const char*>(&response) + sizeof(response));
+                close_connection = true;
+                break;
+            }
+            
+            size_t payload = static_cast<size_t>(request.count) * sizeof(double);
+            if (filled - consumed < sizeof(PredictionHeader) + payload) {
+                break;
+            }
+            
+            values.resize(request.count);
+            memcpy(values.data(), input.data() + consumed + sizeof(PredictionHeader), payload);
+            consumed += sizeof(PredictionHeader) + payload;
+            
+            PredictionHeader response = {PREDICTION_OK, request.count};
+            if (request.id_or_status >= models.size()) {
+                response = {PREDICTION_UNKNOWN_MODEL, 0};
             } else {
-                cout << "*** ERROR: Please provide a valid CSV file path." << endl;
-                return;
+                predictions.resize(request.count);
+                models[request.id_or_status]->predictBatch(values.data(), predictions.data(), request.count);
+            }
+            
+            output.insert(output.end(), reinterpret_cast<const char*>(&response),
+                          reinterpret_cast<const char*>(&response) + sizeof(response));
+            if (response.id_or_status == PREDICTION_OK) {
+                const char* bytes = reinterpret_cast<const char*>(predictions.data());
+                output.insert(output.end(), bytes, bytes + response.count * sizeof(double));
+            }
+        }
+        
+        if (consumed > 0) {
+            memmove(input.data(), input.data() + consumed, filled - consumed);
+            filled -= consumed;
+        }
+        if (!output.empty() && !sendAll(client, output.data(), output.size())) {
+            break;
+        }
+        if (close_connection) {
+            break;
+        }
+    }
+    
+    closeSocket(client);
+}
+
+// serve [--port P] [--method ls|gd|sgd|online] <data.csv|model.lrmodel>...
+// Trains (or loads) one model per file (model_id = position) and serves predictions on
+// 127.0.0.1 with one thread per connection until the process is stopped
+int runPredictionServer(int argc, char* argv[]) {
+    uint16_t port = 5555;
+    TrainCommandOptions options;
+    options.gradient.threads = 0;
+    options.gradient.standardize = true;
+    vector<string> files;
+    
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            if (!parseArgument(string(argv[++i]), port) || port == 0) {
+                cerr << "*** ERROR: Invalid port: " << argv[i] << endl;
+                return EXIT_CODE_USAGE;
+            }
+        } else if (arg == "--method" && i + 1 < argc) {
+            options.method = argv[++i];
+            if (options.method != "ls" && options.method != "gd" &&
+                options.method != "sgd" && options.method != "online") {
+                cerr << "*** ERROR: Invalid value for --method: " << options.method << endl;
+                return EXIT_CODE_USAGE;
+            }
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        cerr << "Usage: " << argv[0] << " serve [--port P] [--method ls|gd|sgd|online] <data.csv>..." << endl;
+        return EXIT_CODE_USAGE;
+    }
+    
+    vector<unique_ptr<LinearRegression>> models;
+    for (const auto& file : files) {
+        try {
+            auto lr = make_unique<LinearRegression>();
+            lr->setVerbose(false);
+            if (filesystem::path(file).extension() == ".lrmodel") {
+                lr->loadModel(file);
+            } else {
+                lr->loadData(file, 0);
+                selectTrainMethod(*lr, options);
+                lr->trainModel();
+            }
+            cout << "*** MODEL " << models.size() << ": " << file << " (y = "
+                 << lr->getModel().getSlope() << " * x + " << lr->getModel().getIntercept() << ")" << endl;
+            models.push_back(move(lr));
+        } catch (const exception& e) {
+            cerr << "*** ERROR Training " << file << " failed: " << e.what() << endl;
+            return EXIT_CODE_FAILED;
+        }
+    }
+    
+    try {
+        SocketLibrary sockets;
+        SocketHandle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listener == INVALID_SOCKET_HANDLE) {
+            throw runtime_error("Cannot create socket");
+        }
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        
+        sockaddr_in address = loopbackAddress(port);
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, SOMAXCONN) != 0) {
+            closeSocket(listener);
+            throw runtime_error("Cannot listen on 127.0.0.1:" + to_string(port));
+        }
+        cout << "*** SERVING " << models.size() << " model(s) on 127.0.0.1:" << port << endl;
+        
+        while (true) {
+            SocketHandle client = accept(listener, nullptr, nullptr);
+            if (client == INVALID_SOCKET_HANDLE) {
+                continue;
+            }
+            disableNagle(client);
+            // Models are never modified after this point, so connections
+            // share them without locking
+            thread(servePredictionConnection, client, cref(models)).detach();
+        }
+    } catch (const exception& e) {
+        cerr << "*** ERROR: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+}
+
+// loadgen [--port P] [--model ID] [--requests N] [--batch B] [--pipeline D]
+// Sends N requests of B values each with up to D in flight on one
+// connection, and reports latency percentiles and throughput
+int runLoadGenerator(int argc, char* argv[]) {
+    uint16_t port = 5555;
+    uint32_t model_id = 0;
+    size_t total_requests = 100000;
+    uint32_t batch = 1;
+    size_t pipeline = 1;
+    
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        bool valid = i + 1 < argc;
+        string value = valid ? argv[++i] : "";
+        if (arg == "--port") {
+            valid = valid && parseArgument(value, port) && port != 0;
+        } else if (arg == "--model") {
+            valid = valid && parseArgument(value, model_id);
+        } else if (arg == "--requests") {
+            valid = valid && parseArgument(value, total_requests) && total_requests > 0;
+        } else if (arg == "--batch") {
+            valid = valid && parseArgument(value, batch) && batch > 0 && batch <= MAX_PREDICTIONS_PER_REQUEST;
+        } else if (arg == "--pipeline") {
+            valid = valid && parseArgument(value, pipeline) && pipeline > 0;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            cerr << "Usage: " << argv[0] << " loadgen [--port P] [--model ID] [--requests N]"
+                 << " [--batch B] [--pipeline D]" << endl;
+            return EXIT_CODE_USAGE;
+        }
+    }
+    
+    try {
+        SocketLibrary sockets;
+        SocketHandle connection = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in address = loopbackAddress(port);
+        if (connection == INVALID_SOCKET_HANDLE ||
+            connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            throw runtime_error("Cannot connect to 127.0.0.1:" + to_string(port));
+        }
+        disableNagle(connection);
+        
+        // One request image reused for every send
+        vector<char> request(sizeof(PredictionHeader) + batch * sizeof(double));
+        PredictionHeader header = {model_id, batch};
+        memcpy(request.data(), &header, sizeof(header));
+        for (uint32_t i = 0; i < batch; ++i) {
+            double x = 1000.0 + i;
+            memcpy(request.data() + sizeof(header) + i * sizeof(double), &x, sizeof(x));
+        }
+        vector<char> response(request.size());
+        
+        vector<double> latencies;
+        latencies.reserve(total_requests);
+        vector<chrono::steady_clock::time_point> send_times(pipeline);
+        size_t sent = 0;
+        size_t answered = 0;
+        
+        auto start_time = chrono::steady_clock::now();
+        while (answered < total_requests) {
+            while (sent < total_requests && sent - answered < pipeline) {
+                send_times[sent % pipeline] = chrono::steady_clock::now();
+                if (!sendAll(connection, request.data(), request.size())) {
+                    throw runtime_error("Connection closed while sending");
+                }
+                ++sent;
+            }
+            
+            PredictionHeader reply;
+            if (!receiveAll(connection, reinterpret_cast<char*>(&reply), sizeof(reply))) {
+                throw runtime_error("Connection closed while receiving");
+            }
+            if (reply.id_or_status != PREDICTION_OK) {
+                throw runtime_error("Server returned status " + to_string(reply.id_or_status));
+            }
+            if (!receiveAll(connection, response.data(), reply.count * sizeof(double))) {
+                throw runtime_error("Connection closed while receiving");
+            }
+            
+            auto now = chrono::steady_clock::now();
+            latencies.push_back(chrono::duration<double, micro>(now - send_times[answered % pipeline]).count());
+            ++answered;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        closeSocket(connection);
+        
+        sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) {
+            return latencies[min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+        };
+        
+        cout << fixed << setprecision(1);
+        cout << "*** LOADGEN " << total_requests << " requests x " << batch << " values, pipeline "
+             << pipeline << "\n"
+             << "Latency (us): p50 " << percentile(0.50) << ", p90 " << percentile(0.90)
+             << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999)
+             << ", max " << latencies.back() << "\n"
+             << "Throughput: " << total_requests / seconds << " requests/s, "
+             << total_requests * static_cast<double>(batch) / seconds << " predictions/s" << endl;
+    } catch (const exception& e) {
+        cerr << "*** ERROR: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+    return EXIT_CODE_OK;
+}
+
+// Score x values with a saved model; no training data is read
+int runSavedModelScoring(const string& model_file, const string& input_file, const string& output_file) {
+    ios::sync_with_stdio(false);
+    LinearRegression lr;
+    
+    auto start_time = chrono::steady_clock::now();
+    try {
+        lr.loadModel(model_file);
+    } catch (const exception& e) {
+        cerr << "*** ERROR: " << e.what() << "\n";
+        return EXIT_CODE_FAILED;
+    }
+    double startup_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start_time).count();
+    
+    ifstream input_stream;
+    ofstream output_stream;
+    if (input_file != "-") {
+        input_stream.open(input_file, ios::binary);
+        if (!input_stream.is_open()) {
+            cerr << "*** ERROR: Cannot open file: " << input_file << "\n";
+            return EXIT_CODE_FAILED;
+        }
+    }
+    if (output_file != "-") {
+        output_stream.open(output_file, ios::binary | ios::trunc);
+        if (!output_stream.is_open()) {
+            cerr << "*** ERROR: Cannot create file: " << output_file << "\n";
+            return EXIT_CODE_FAILED;
+        }
+    }
+    
+    istream& input = (input_file == "-") ? cin : input_stream;
+    ostream& output = (output_file == "-") ? cout : static_cast<ostream&>(output_stream);
+    size_t rows = scoreCSVStream(lr, input, output);
+    output.flush();
+    
+    if (!output) {
+        cerr << "*** ERROR: Failed writing predictions\n";
+        return EXIT_CODE_FAILED;
+    }
+    cerr << "*** SCORED " << rows << " rows; model loaded in " << startup_us << " us\n";
+    return EXIT_CODE_OK;
+}
+
+int runModelExport(const string& model_file, const string& output_file) {
+    try {
+        LinearRegression lr;
+        lr.loadModel(model_file);
+        if (output_file == "-") {
+            lr.exportModelText(cout);
+        } else {
+            ofstream out(output_file, ios::trunc);
+            if (!out.is_open()) {
+                throw runtime_error("Cannot create file: " + output_file);
+            }
+            lr.exportModelText(out);
+        }
+    } catch (const exception& e) {
+        cerr << "*** ERROR: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
+    }
+    return EXIT_CODE_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Synthetic data generator
+// ---------------------------------------------------------------------------
+
+enum class NoiseDistribution {
+    Gaussian,
+    Uniform,
+    Laplace,
+    Cauchy
+};
+
+struct SyntheticDataOptions {
+    uint64_t rows = 1000;
+    double slope = 3.0;
+    double intercept = 2.0;
+    double x_min = 0.0;
+    double x_max = 100.0;
+    NoiseDistribution noise = NoiseDistribution::Gaussian;
+    double noise_scale = 1.0;    // standard deviation for Gaussian, half-width for Uniform
+    double outlier_rate = 0.0;   // probability a row gets an extra gross error
+    double outlier_scale = 50.0; // standard deviation of that error
+    uint64_t seed = 42;
+    unsigned threads = 0;        // 0 = one per core; output does not depend on it
+    string x_label = "x";
+    string y_label = "y";
+};
+
+// SplitMix64: used to seed one independent stream per chunk, so chunk k
+// holds the same rows however many threads generate the file
+inline uint64_t splitMix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Generates rows from one chunk stream. The distributions are written out
+// here rather than taken from <random>, whose algorithms differ between
+// standard libraries, so a seed gives the same file on every platform.
+class SyntheticRowSource {
+private:
+    mt19937_64 engine;
+    const SyntheticDataOptions& options;
+    
+    // Uniform in (0, 1) from the top 53 bits
+    double uniform() {
+        return ((engine() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    }
+    
+    double gaussian() {
+        // Box-Muller; the second value is dropped to keep the stream simple
+        return sqrt(-2.0 * log(uniform())) * cos(6.283185307179586 * uniform());
+    }
+    
+    double noise() {
+        switch (options.noise) {
+            case NoiseDistribution::Uniform:
+                return (2.0 * uniform() - 1.0) * options.noise_scale;
+            case NoiseDistribution::Laplace: {
+                double u = uniform() - 0.5;
+                double b = options.noise_scale / sqrt(2.0);
+                return (u < 0 ? b : -b) * log(1.0 - 2.0 * fabs(u));
             }
+            case NoiseDistribution::Cauchy:
+                return options.noise_scale * tan(3.141592653589793 * (uniform() - 0.5));
+            default:
+                return options.noise_scale * gaussian();
         }
     }
+
+public:
+    SyntheticRowSource(const SyntheticDataOptions& options, uint64_t chunk)
+        : engine(splitMix64(options.seed ^ splitMix64(chunk))), options(options) {}
     
-    // Step 4: Load Data
-    try {
-        cout << "\n*** LOADING DATA FROM: " << filepath << endl;
-        lr.loadData(filepath);
-        lr.displayDatasetSummary();
-    } catch (const exception& e) {
-        cout << "*** ERROR loading file: " << e.what() << endl;
-        return;
+    void next(double& x, double& y) {
+        x = options.x_min + (options.x_max - options.x_min) * uniform();
+        y = options.slope * x + options.intercept + noise();
+        if (options.outlier_rate > 0 && uniform() < options.outlier_rate) {
+            y += options.outlier_scale * gaussian();
+        }
     }
+};
+
+// Write options.rows rows to csv_file and, when binary_file is not empty,
+// the same values as .lrbin. Rows are produced in fixed 64K-row chunks on
+// the ThreadPool, a round of chunks at a time, and written in order with
+// one large write per chunk, so memory stays bounded for any row count.
+void generateSyntheticDataset(const SyntheticDataOptions& options, const string& csv_file,
+                              const string& binary_file) {
+    const uint64_t chunk_rows = 1 << 16;
+    // Longest shortest-form double is 24 chars; two per row plus ',' and '\n'
+    const size_t max_row_chars = 2 * 24 + 2;
     
-    // Step 5: Model Selection
-    cout << "\n*** SELECT REGRESSION METHOD ***" << endl;
-    cout << "1. Gradient Descent (Better for large datasets)" << endl;
-    cout << "2. Least Squares (Faster for small datasets)" << endl;
-    cout << "Enter choice (1 or 2): ";
+    ofstream csv(csv_file, ios::binary | ios::trunc);
+    if (!csv.is_open()) {
+        throw runtime_error("Cannot create file: " + csv_file);
+    }
+    csv << options.x_label << ',' << options.y_label << '\n';
     
-    string modelChoice;
-    cin >> modelChoice;
+    string binary_temp = binary_file + ".tmp";
+    ofstream binary;
+    BinaryDatasetHeader header = makeBinaryDatasetHeader(options.rows, options.x_label, options.y_label);
+    if (!binary_file.empty()) {
+        binary.open(binary_temp, ios::binary | ios::trunc);
+        if (!binary.is_open()) {
+            throw runtime_error("Cannot create file: " + binary_temp);
+        }
+        const char padding[BINARY_DATASET_ALIGNMENT] = {};
+        uint64_t labels_end = sizeof(header) + options.x_label.size() + options.y_label.size();
+        binary.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        binary.write(options.x_label.data(), options.x_label.size());
+        binary.write(options.y_label.data(), options.y_label.size());
+        binary.write(padding, header.data_offset - labels_end);
+    }
     
-    if (modelChoice == "1") {
-        double lr_rate;
-        int max_iter;
+    struct Chunk {
+        vector<double> x;
+        vector<double> y;
+        vector<char> text;
+        size_t text_size = 0;
+    };
+    
+    uint64_t chunk_count = (options.rows + chunk_rows - 1) / chunk_rows;
+    ThreadPool pool(min<uint64_t>(resolveThreadCount(options.threads), max<uint64_t>(1, chunk_count)));
+    vector<Chunk> round(pool.size() * 4);
+    
+    for (uint64_t first_chunk = 0; first_chunk < chunk_count; first_chunk += round.size()) {
+        size_t round_chunks = static_cast<size_t>(min<uint64_t>(round.size(), chunk_count - first_chunk));
         
-        // Get learning rate with validation
-        cout << "Enter learning rate (0.001 to 1.0, default 0.01): ";
-        cin >> lr_rate;
+        pool.run([&](size_t worker) {
+            for (size_t slot = worker; slot < round_chunks; slot += pool.size()) {
+                uint64_t chunk_index = first_chunk + slot;
+                uint64_t begin_row = chunk_index * chunk_rows;
+                size_t n = static_cast<size_t>(min(chunk_rows, options.rows - begin_row));
+                
+                Chunk& chunk = round[slot];
+                chunk.x.resize(n);
+                chunk.y.resize(n);
+                chunk.text.resize(n * max_row_chars);
+                
+                SyntheticRowSource source(options, chunk_index);
+                char* cursor = chunk.text.data();
+                char* text_end = chunk.text.data() + chunk.text.size();
+                for (size_t i = 0; i < n; ++i) {
+                    source.next(chunk.x[i], chunk.y[i]);
+                    cursor = to_chars(cursor, text_end, chunk.x[i]).ptr;
+                    *cursor++ = ',';
+                    cursor = to_chars(cursor, text_end, chunk.y[i]).ptr;
+                    *cursor++ = '\n';
+                }
+                chunk.text_size = cursor - chunk.text.data();
+            }
+        });
         
-        if (lr_rate <= 0 || lr_rate > 1.0) {
-            cout << "*** WARNING: Invalid learning rate. Using default 0.01" << endl;
-            lr_rate = 0.01;
+        for (size_t slot = 0; slot < round_chunks; ++slot) {
+            const Chunk& chunk = round[slot];
+            csv.write(chunk.text.data(), chunk.text_size);
+            
+            if (binary.is_open()) {
+                uint64_t begin_row = (first_chunk + slot) * chunk_rows;
+                size_t bytes = chunk.x.size() * sizeof(double);
+                binary.seekp(header.data_offset + begin_row * sizeof(double));
+                binary.write(reinterpret_cast<const char*>(chunk.x.data()), bytes);
+                binary.seekp(header.data_offset + (options.rows + begin_row) * sizeof(double));
+                binary.write(reinterpret_cast<const char*>(chunk.y.data()), bytes);
+            }
         }
         
-        cout << "Enter max iterations (100 to 100000, default 1000): ";
-        cin >> max_iter;
+        if (!csv || (binary.is_open() && !binary)) {
+            throw runtime_error("Failed writing generated data");
+        }
+    }
+    
+    csv.close();
+    if (!csv) {
+        throw runtime_error("Failed writing file: " + csv_file);
+    }
+    if (binary.is_open()) {
+        binary.close();
+        if (!binary) {
+            throw runtime_error("Failed writing file: " + binary_temp);
+        }
+        filesystem::rename(binary_temp, binary_file);
+        // Make sure the cache counts as fresh for the CSV written just before
+        filesystem::last_write_time(binary_file, filesystem::file_time_type::clock::now());
+    }
+}
+
+// generate <out.csv> [--rows N] [--slope S] [--intercept B] [--x-range MIN,MAX]
+//          [--noise gaussian|uniform|laplace|cauchy] [--noise-scale S]
+//          [--outliers RATE] [--outlier-scale S] [--seed N] [--threads N]
+//          [--labels X,Y] [--binary [file.lrbin]]
+int runDataGenerator(int argc, char* argv[]) {
+    SyntheticDataOptions options;
+    string csv_file;
+    string binary_file;
+    
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            if (!csv_file.empty()) {
+                cerr << "*** ERROR: Unexpected argument: " << arg << endl;
+                return EXIT_CODE_USAGE;
+            }
+            csv_file = arg;
+            continue;
+        }
+        if (arg == "--binary") {
+            // Optional value: the next argument if it is a .lrbin path
+            if (i + 1 < argc && filesystem::path(argv[i + 1]).extension() == ".lrbin") {
+                binary_file = argv[++i];
+            } else {
+                binary_file = "=";
+            }
+            continue;
+        }
         
-        if (max_iter < 100 || max_iter > 100000) {
-            cout << "*** WARNING: Invalid iterations. Using default 1000" << endl;
-            max_iter = 1000;
+        bool valid = i + 1 < argc;
+        string value = valid ? argv[++i] : "";
+        double number = 0.0;
+        if (arg == "--rows") {
+            // Accept 1e9 style as well as plain integers
+            valid = valid && parseArgument(value, number) && number >= 1 && number <= 1e15;
+            options.rows = static_cast<uint64_t>(number);
+        } else if (arg == "--slope") {
+            valid = valid && parseArgument(value, options.slope);
+        } else if (arg == "--intercept") {
+            valid = valid && parseArgument(value, options.intercept);
+        } else if (arg == "--x-range") {
+            size_t comma = value.find(',');
+            valid = valid && comma != string::npos &&
+                    parseArgument(value.substr(0, comma), options.x_min) &&
+                    parseArgument(value.substr(comma + 1), options.x_max) && options.x_min < options.x_max;
+        } else if (arg == "--noise") {
+            static const map<string, NoiseDistribution> distributions = {
+                {"gaussian", NoiseDistribution::Gaussian}, {"uniform", NoiseDistribution::Uniform},
+                {"laplace", NoiseDistribution::Laplace}, {"cauchy", NoiseDistribution::Cauchy}
+            };
+            auto found = distributions.find(value);
+            valid = valid && found != distributions.end();
+            if (valid) {
+                options.noise = found->second;
+            }
+        } else if (arg == "--noise-scale") {
+            valid = valid && parseArgument(value, options.noise_scale) && options.noise_scale >= 0;
+        } else if (arg == "--outliers") {
+            valid = valid && parseArgument(value, options.outlier_rate) &&
+                    options.outlier_rate >= 0 && options.outlier_rate <= 1;
+        } else if (arg == "--outlier-scale") {
+            valid = valid && parseArgument(value, options.outlier_scale) && options.outlier_scale >= 0;
+        } else if (arg == "--seed") {
+            valid = valid && parseArgument(value, options.seed);
+        } else if (arg == "--threads") {
+            valid = valid && parseArgument(value, options.threads);
+        } else if (arg == "--labels") {
+            size_t comma = value.find(',');
+            valid = valid && comma != string::npos && comma > 0 && comma + 1 < value.size();
+            if (valid) {
+                options.x_label = value.substr(0, comma);
+                options.y_label = value.substr(comma + 1);
+            }
+        } else {
+            cerr << "*** ERROR: Unknown option: " << arg << endl;
+            return EXIT_CODE_USAGE;
         }
         
-        lr.useGradientDescent(lr_rate, max_iter);
-        cout << "*** SUCCESS: Using Gradient Descent" << endl;
-    } else if (modelChoice == "2") {
-        lr.useLeastSquares();
-        cout << "*** SUCCESS: Using Least Squares" << endl;
-    } else {
-        cout << "*** WARNING: Invalid choice. Using Least Squares by default." << endl;
-        lr.useLeastSquares();
+        if (!valid) {
+            cerr << "*** ERROR: Invalid value for " << arg << ": " << value << endl;
+            return EXIT_CODE_USAGE;
+        }
+    }
+    
+    if (csv_file.empty()) {
+        cerr << "Usage: " << argv[0] << " generate <out.csv> [--rows N] [--slope S] [--intercept B]"
+             << " [--noise gaussian|uniform|laplace|cauchy] [--noise-scale S] [--outliers RATE]"
+             << " [--seed N] [--binary [file.lrbin]] (see help)" << endl;
+        return EXIT_CODE_USAGE;
+    }
+    if (binary_file == "=") {
+        binary_file = binaryCachePath(csv_file);
     }
     
-    // Step 6: Train Model
     try {
-        cout << "\n*** TRAINING MODEL ***" << endl;
-        lr.trainModel();
-        cout << "*** SUCCESS: Model trained successfully!" << endl;
-        lr.displayResults();
+        auto start_time = chrono::steady_clock::now();
+        generateSyntheticDataset(options, csv_file, binary_file);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        
+        uintmax_t bytes = filesystem::file_size(csv_file);
+        cout << "*** GENERATED " << options.rows << " rows, " << bytes / 1e6 << " MB in " << seconds
+             << " s (" << bytes / seconds / 1e6 << " MB/s): " << csv_file;
+        if (!binary_file.empty()) {
+            cout << " + " << binary_file;
+        }
+        cout << endl;
     } catch (const exception& e) {
-        cout << "*** ERROR Training failed: " << e.what() << endl;
-        return;
+        cerr << "*** ERROR Generation failed: " << e.what() << endl;
+        return EXIT_CODE_FAILED;
     }
+    return EXIT_CODE_OK;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+struct BenchmarkResult {
+    string name;
+    size_t rows = 0;          // dataset size
+    double work_rows = 0.0;   // rows processed per run (rows x passes)
+    uint64_t bytes = 0;       // input bytes per run, 0 when not meaningful
+    double seconds = 0.0;     // best of the repeats
+    // getrusage's high-water mark for the whole process when the benchmark
+    // finished: it never goes down, so it covers every earlier benchmark and
+    // size too and is not this benchmark's own footprint
+    size_t process_peak_rss = 0;
+};
+
+// Fastest of `repeat` runs; the minimum is the least noisy estimate
+template <typename Body>
+double bestSeconds(int repeat, Body&& body) {
+    double best = numeric_limits<double>::infinity();
+    for (int i = 0; i < repeat; ++i) {
+        auto start_time = chrono::steady_clock::now();
+        body();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start_time).count());
+    }
+    return best;
+}
+
+// Values written into a volatile so the optimizer keeps benchmarked work
+volatile double benchmark_sink = 0.0;
+
+// Run every benchmark for one dataset size, appending to results
+void runBenchmarksForSize(size_t rows, int repeat, const string& directory, StoragePrecision precision,
+                          vector<BenchmarkResult>& results) {
+    string csv_file = (filesystem::path(directory) / ("bench_" + to_string(rows) + ".csv")).string();
+    string binary_file = binaryCachePath(csv_file);
+    SyntheticDataOptions generator;
+    generator.rows = rows;
+    generator.seed = 42 + rows;
+    generator.threads = 0;
+    generateSyntheticDataset(generator, csv_file, "");
+    uint64_t csv_bytes = filesystem::file_size(csv_file);
     
-    // Step 7: Prediction Loop
-    auto prompts = getCategoryPrompts(categoryId);
-    string inputPrompt = prompts.first;
-    string outputLabel = prompts.second;
+    auto record = [&](const string& name, double work_rows, uint64_t bytes, double seconds) {
+        BenchmarkResult result;
+        result.name = name;
+        result.rows = rows;
+        result.work_rows = work_rows;
+        result.bytes = bytes;
+        result.seconds = seconds;
+        result.process_peak_rss = peakResidentBytes();
+        results.push_back(result);
+    };
     
-    cout << "\n*** PREDICTION MODE ***" << endl;
-    cout << "=======================" << endl;
-    cout << "I can predict " << outputLabel << " based on " << inputPrompt << endl;
-    cout << "*** WARNING: Predictions are most accurate within the training data range ***" << endl;
-    cout << "Enter -1 to exit prediction mode" << endl;
+    // Ingestion
+    Dataset dataset;
+    dataset.setStoragePrecision(precision);
+    record("load_csv_stream", rows, csv_bytes, bestSeconds(repeat, [&] { dataset.loadFromCSV(csv_file); }));
+    record("load_csv_mapped", rows, csv_bytes, bestSeconds(repeat, [&] { dataset.loadFromCSVMapped(csv_file); }));
+    record("load_csv_parallel", rows, csv_bytes, bestSeconds(repeat, [&] { dataset.loadFromCSVParallel(csv_file, 0); }));
+    dataset.saveBinary(binary_file);
+    uint64_t binary_bytes = filesystem::file_size(binary_file);
+    // Mapping alone is lazy, so the timing includes one read of every value
+    record("load_binary", rows, binary_bytes, bestSeconds(repeat, [&] {
+        dataset.loadFromBinary(binary_file);
+        benchmark_sink = dataset.visitColumns([](auto x_vals, auto y_vals) {
+            double sum = 0.0;
+            forEachRowSpan(x_vals, y_vals, 0, x_vals.size(), [&](const auto* x, const auto* y, size_t n) {
+                sum = accumulate(y, y + n, accumulate(x, x + n, sum));
+            });
+            return sum;
+        });
+    }));
     
-    while (true) {
-        double inputValue;
-        
-        cout << "\nEnter " << inputPrompt << " (or -1 to exit): ";
-        cin >> inputValue;
+    // Training; tolerance 0 makes gradient descent run a fixed number of passes
+    dataset.loadFromCSVMapped(csv_file);
+    const int gd_iterations = 20;
+    LeastSquaresModel least_squares;
+    record("train_least_squares", rows, 0, bestSeconds(repeat, [&] { least_squares.train(dataset); }));
+    
+    GradientDescentOptions options;
+    options.max_iterations = gd_iterations;
+    options.tolerance = 0.0;
+    options.learning_rate = 1e-4;
+    GradientDescentModel full_pass(options);
+    record("train_gd_full_pass", static_cast<double>(rows) * gd_iterations, 0,
+           bestSeconds(repeat, [&] { full_pass.train(dataset); }));
+    
+    options.threads = 0;
+    GradientDescentModel threaded(options);
+    record("train_gd_threaded", static_cast<double>(rows) * gd_iterations, 0,
+           bestSeconds(repeat, [&] { threaded.train(dataset); }));
+    
+    options.threads = 1;
+    options.mode = GradientMode::Moments;
+    GradientDescentModel moments(options);
+    record("train_gd_moments", rows, 0, bestSeconds(repeat, [&] { moments.train(dataset); }));
+    
+    // Evaluation and prediction
+    record("calculate_mse", rows, 0, bestSeconds(repeat, [&] {
+        benchmark_sink = least_squares.calculateMSE(dataset);
+    }));
+    
+    dataset.visitColumns([&](auto x_vals, auto) {
+        record("predict_scalar", rows, 0, bestSeconds(repeat, [&] {
+            double sum = 0.0;
+            x_vals.forEachSpan(0, rows, [&](const auto* x, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    sum += least_squares.predict(x[i]);
+                }
+            });
+            benchmark_sink = sum;
+        }));
         
-        if (inputValue == -1) {
-            break;
+        vector<double> predictions(rows);
+        record("predict_batch", rows, 0, bestSeconds(repeat, [&] {
+            double* out = predictions.data();
+            x_vals.forEachSpan(0, rows, [&](const auto* x, size_t n) {
+                least_squares.predictBatch(x, out, n);
+                out += n;
+            });
+            benchmark_sink = predictions[rows / 2];
+        }));
+    });
+    
+    dataset = Dataset();
+    filesystem::remove(csv_file);
+    filesystem::remove(binary_file);
+}
+
+void writeBenchmarkJSON(ostream& out, const vector<BenchmarkResult>& results, int repeat,
+                        StoragePrecision precision) {
+    out << setprecision(9);
+    out << "{\n"
+        << "  \"simd\": \"" << simdLevelName(detectSimdLevel()) << "\",\n"
+        << "  \"precision\": \"" << storagePrecisionName(precision) << "\",\n"
+        << "  \"hardware_threads\": " << resolveThreadCount(0) << ",\n"
+        << "  \"repeat\": " << repeat << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << "    {\"benchmark\": \"" << r.name << "\", \"rows\": " << r.rows
+            << ", \"seconds\": " << r.seconds
+            << ", \"rows_per_second\": " << r.work_rows / r.seconds
+            << ", \"bytes_per_second\": " << (r.bytes > 0 ? r.bytes / r.seconds : 0.0)
+            << ", \"ns_per_row\": " << r.seconds * 1e9 / r.work_rows
+            << ", \"process_peak_rss_bytes\": " << r.process_peak_rss << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+// bench [--sizes N,N,...] [--max-rows N] [--repeat R] [--dir D] [--output file.json]
+//       [--precision double|float32]
+// Default sizes are the powers of ten from 10^3 up to --max-rows (10^7);
+// each size gets a synthetic CSV that is deleted afterwards
+int runBenchmarks(int argc, char* argv[]) {
+    vector<size_t> sizes;
+    StoragePrecision precision = StoragePrecision::Double;
+    size_t max_rows = 10000000;
+    int repeat = 3;
+    string directory = filesystem::temp_directory_path().string();
+    string output_file;
+    
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        bool valid = i + 1 < argc;
+        string value = valid ? argv[++i] : "";
+        if (arg == "--sizes") {
+            stringstream list(value);
+            string item;
+            while (valid && getline(list, item, ',')) {
+                // Accept 1e6 style as well as plain integers
+                double parsed = 0.0;
+                valid = parseArgument(item, parsed) && parsed >= 2 && parsed <= 1e12;
+                sizes.push_back(static_cast<size_t>(parsed));
+            }
+        } else if (arg == "--max-rows") {
+            double parsed = 0.0;
+            valid = valid && parseArgument(value, parsed) && parsed >= 1000;
+            max_rows = static_cast<size_t>(parsed);
+        } else if (arg == "--repeat") {
+            valid = valid && parseArgument(value, repeat) && repeat > 0;
+        } else if (arg == "--dir") {
+            directory = value;
+        } else if (arg == "--output") {
+            output_file = value;
+        } else if (arg == "--precision") {
+            valid = valid && parseStoragePrecision(value, precision);
+        } else {
+            valid = false;
         }
-        
+        if (!valid) {
+            cerr << "Usage: " << argv[0] << " bench [--sizes N,N,...] [--max-rows N] [--repeat R]"
+                 << " [--dir D] [--output file.json] [--precision double|float32]" << endl;
+            return EXIT_CODE_USAGE;
+        }
+    }
+    if (sizes.empty()) {
+        for (size_t rows = 1000; rows <= max_rows; rows *= 10) {
+            sizes.push_back(rows);
+        }
+    }
+    
+    vector<BenchmarkResult> results;
+    cerr << left << setw(22) << "Benchmark" << right << setw(12) << "Rows" << setw(14) << "Rows/s"
+         << setw(12) << "MB/s" << setw(12) << "ns/row" << setw(16) << "Proc peak MB" << "\n";
+    for (size_t rows : sizes) {
+        size_t first = results.size();
         try {
-            double prediction = lr.predict(inputValue);
-            cout << "*** PREDICTION RESULT ***" << endl;
-            cout << "For " << inputPrompt << ": " << inputValue << endl;
-            cout << "Predicted " << outputLabel << ": " << prediction << endl;
-            
-            // Add category-specific validation
-            if (categoryId == "1") { // Education
-                if (prediction > 100) {
-                    cout << "*** WARNING: Predicted score exceeds 100 marks!" << endl;
-                    cout << "*** REALISTIC ESTIMATE: Maximum possible score is ~100" << endl;
-                }
-                
-                if (prediction >= 90) cout << "*** ANALYSIS: Excellent score!" << endl;
-                else if (prediction >= 75) cout << "*** ANALYSIS: Good score!" << endl;
-                else if (prediction >= 60) cout << "*** ANALYSIS: Average score" << endl;
-                else cout << "*** ANALYSIS: Needs improvement" << endl;
-            }
-            else if (categoryId == "2") { // Real Estate
-                if (prediction < 0) {
-                    cout << "*** WARNING: Negative price predicted!" << endl;
-                    cout << "*** REALISTIC ESTIMATE: Minimum price should be > 0" << endl;
-                }
-                cout << "*** ANALYSIS: Estimated property value" << endl;
-            }
-            else if (categoryId == "3") { // Business
-                if (prediction < 0) {
-                    cout << "*** WARNING: Negative sales predicted!" << endl;
-                }
-                cout << "*** ANALYSIS: Expected sales revenue" << endl;
-            }
-            else if (categoryId == "4") { // Healthcare
-                if (prediction > 100) {
-                    cout << "*** WARNING: Recovery rate exceeds 100%!" << endl;
-                }
-                if (prediction >= 80) cout << "*** ANALYSIS: High recovery rate!" << endl;
-                else if (prediction >= 60) cout << "*** ANALYSIS: Good recovery rate" << endl;
-                else cout << "*** ANALYSIS: Continuing treatment needed" << endl;
-            }
-            else if (categoryId == "5") { // Sports
-                if (prediction > 100) {
-                    cout << "*** WARNING: Performance score exceeds 100!" << endl;
-                }
-                if (prediction >= 90) cout << "*** ANALYSIS: Elite performance!" << endl;
-                else if (prediction >= 80) cout << "*** ANALYSIS: Great performance!" << endl;
-                else if (prediction >= 70) cout << "*** ANALYSIS: Good performance" << endl;
-                else cout << "*** ANALYSIS: Keep training!" << endl;
-            }
-            else if (categoryId == "6") { // Salary
-                if (prediction < 0) {
-                    cout << "*** WARNING: Negative salary predicted!" << endl;
-                }
-                cout << "*** ANALYSIS: Estimated annual salary" << endl;
-            }
-            else if (categoryId == "7") { // Temperature
-                cout << "*** ANALYSIS: Expected ice cream sales" << endl;
-            }
-            else if (categoryId == "8") { // Car valuation
-                if (prediction < 0) {
-                    cout << "*** WARNING: Negative car price predicted!" << endl;
-                }
-                cout << "*** ANALYSIS: Estimated car value" << endl;
-            }
-            else { // Custom
-                cout << "*** ANALYSIS: Predicted output based on input" << endl;
-            }
-            
+            runBenchmarksForSize(rows, repeat, directory, precision, results);
         } catch (const exception& e) {
-            cout << "*** ERROR Prediction error: " << e.what() << endl;
+            cerr << "*** ERROR: Benchmark at " << rows << " rows failed: " << e.what() << endl;
+            return EXIT_CODE_FAILED;
+        }
+        for (size_t i = first; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            cerr << left << setw(22) << r.name << right << setw(12) << r.rows
+                 << fixed << setprecision(0) << setw(14) << r.work_rows / r.seconds
+                 << setprecision(1) << setw(12) << (r.bytes > 0 ? r.bytes / r.seconds / 1e6 : 0.0)
+                 << setprecision(2) << setw(12) << r.seconds * 1e9 / r.work_rows
+                 << setprecision(1) << setw(16) << r.process_peak_rss / 1e6 << "\n";
+            cerr.unsetf(ios::floatfield);
         }
     }
     
-    cout << "\n*** Thank you for using Linear Regression Predictor!" << endl;
-    cout << "*** Category: " << currentCategory << endl;
+    if (output_file.empty() || output_file == "-") {
+        writeBenchmarkJSON(cout, results, repeat, precision);
+    } else {
+        ofstream out(output_file, ios::trunc);
+        if (!out.is_open()) {
+            cerr << "*** ERROR: Cannot create file: " << output_file << endl;
+            return EXIT_CODE_FAILED;
+        }
+        writeBenchmarkJSON(out, results, repeat, precision);
+    }
+    return EXIT_CODE_OK;
 }
 
-int main() {
+int runInteractive() {
     cout << "*** LINEAR REGRESSION PREDICTION SYSTEM ***" << endl;
     cout << "===========================================" << endl;
     cout << "Predict outcomes based on your data!" << endl;
     
     runCategoryWorkflow();
     
-    return 0;
-}
\ No newline at end of file
+    return EXIT_CODE_OK;
+}
+
+// Write the run's metrics as "json" or "prometheus" to file ("-" = stderr)
+void exportRunMetrics(const string& format, const string& file) {
+#ifdef LR_METRICS_ENABLED
+    ofstream file_stream;
+    if (file != "-") {
+        file_stream.open(file, ios::trunc);
+        if (!file_stream.is_open()) {
+            cerr << "*** ERROR: Cannot create file: " << file << endl;
+            return;
+        }
+    }
+    ostream& out = (file == "-") ? cerr : static_cast<ostream&>(file_stream);
+    if (format == "prometheus") {
+        RunMetrics::instance().writePrometheus(out);
+    } else {
+        RunMetrics::instance().writeJSON(out);
+    }
+#else
+    (void)format;
+    (void)file;
+#endif
+}
+
+// Strip the global "--metrics json|prometheus" and "--metrics-file F"
+// options from argv; a metrics file alone asks for JSON, and the file
+// defaults to "-" (stderr). Returns false for an invalid value
+bool extractMetricsOptions(int& argc, char* argv[], string& format, string& file) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if ((arg == "--metrics" || arg == "--metrics-file") && i + 1 < argc) {
+            (arg == "--metrics" ? format : file) = argv[++i];
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    argv[argc] = nullptr;
+    
+    if (format.empty() && !file.empty()) {
+        format = "json";
+    }
+    if (file.empty()) {
+        file = "-";
+    }
+    return format.empty() || format == "json" || format == "prometheus";
+}
+
+// Dispatch one command-line invocation to its subcommand
+int runCommand(int argc, char* argv[]) {
+    if (argc < 2) {
+        return runInteractive();
+    }
+    
+    string command = argv[1];
+    if (command == "interactive" && argc == 2) {
+        return runInteractive();
+    }
+    if (command == "help" || command == "--help" || command == "-h") {
+        printUsage(cout, argv[0]);
+        return EXIT_CODE_OK;
+    }
+    if (command == "train") {
+        return runTrainCommand(argc, argv);
+    }
+    if (command == "batch") {
+        return runBatchCommand(argc, argv);
+    }
+    if (command == "predict" && argc == 5) {
+        return runSavedModelScoring(argv[2], argv[3], argv[4]);
+    }
+    if (command == "export" && (argc == 3 || argc == 4)) {
+        return runModelExport(argv[2], argc == 4 ? argv[3] : "-");
+    }
+    if (command == "generate") {
+        return runDataGenerator(argc, argv);
+    }
+    if (command == "bench") {
+        return runBenchmarks(argc, argv);
+    }
+    if (command == "serve") {
+        return runPredictionServer(argc, argv);
+    }
+    if (command == "loadgen") {
+        return runLoadGenerator(argc, argv);
+    }
+    if (command == "stream" && argc == 3) {
+        return runStreamingTrainer(argv[2]);
+    }
+    if (command == "multi" && argc == 3) {
+        return runMultipleRegression(argv[2]);
+    }
+    if (command == "score" && argc == 5) {
+        return runBulkScoring(argv[2], argv[3], argv[4]);
+    }
+    if (command == "convert" && (argc == 3 || argc == 4)) {
+        return runBinaryConverter(argv[2], argc == 4 ? argv[3] : binaryCachePath(argv[2]));
+    }
+    
+    printUsage(cerr, argv[0]);
+    return EXIT_CODE_USAGE;
+}
+
+#ifndef LR_NO_MAIN
+int main(int argc, char* argv[]) {
+    string metrics_format;
+    string metrics_file;
+    if (!extractMetricsOptions(argc, argv, metrics_format, metrics_file)) {
+        cerr << "*** ERROR: --metrics must be json or prometheus" << endl;
+        return EXIT_CODE_USAGE;
+    }
+    if (!metrics_format.empty()) {
+#ifdef LR_METRICS_ENABLED
+        RunMetrics::instance().setEnabled(true);
+#else
+        cerr << "*** ERROR: Built with LR_DISABLE_METRICS; --metrics is unavailable" << endl;
+        return EXIT_CODE_USAGE;
+#endif
+    }
+    
+    int status = runCommand(argc, argv);
+    if (!metrics_format.empty()) {
+        exportRunMetrics(metrics_format, metrics_file);
+    }
+    return status;
+}
+#endif
\ No newline at end of file
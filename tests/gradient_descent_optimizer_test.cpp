@@ -0,0 +1,82 @@
+// Momentum and Nesterov take tiny steps whenever the velocity changes sign;
+// they must not stop there, but keep going until they reach the least
+// squares fit like the other optimizers.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -pthread -DLR_NO_MAIN tests/gradient_descent_optimizer_test.cpp -o gradient_descent_optimizer_test
+//   ./gradient_descent_optimizer_test
+
+#include "../main.cpp"
+
+static int failures = 0;
+
+static void check(bool condition, const string& what) {
+    if (!condition) {
+        cerr << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+static bool near(double a, double b, double tolerance) {
+    return abs(a - b) <= tolerance * max(1.0, abs(b));
+}
+
+// y = 2.5x - 7 plus unit gaussian noise, x uniform in [0, 100)
+static void fillDataset(LinearRegression& lr, size_t rows) {
+    mt19937_64 rng(7);
+    uniform_real_distribution<double> x_dist(0.0, 100.0);
+    normal_distribution<double> noise(0.0, 1.0);
+    vector<double> x(rows), y(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        x[i] = x_dist(rng);
+        y[i] = 2.5 * x[i] - 7.0 + noise(rng);
+    }
+    lr.addDataPoints(x, y);
+}
+
+// Train with the `train` command's gradient descent defaults
+static void testReachesLeastSquares(Optimizer optimizer) {
+    string name = optimizerName(optimizer);
+    LinearRegression lr;
+    lr.setVerbose(false);
+    fillDataset(lr, 300001);
+
+    lr.useLeastSquares();
+    lr.trainModel();
+    double expected_slope = lr.getModel().getSlope();
+    double expected_intercept = lr.getModel().getIntercept();
+
+    GradientDescentOptions options;
+    options.optimizer = optimizer;
+    options.standardize = true;
+    options.threads = 0;
+    lr.useGradientDescent(options);
+    lr.trainModel();
+
+    check(near(lr.getModel().getSlope(), expected_slope, 1e-4), name + " slope matches least squares");
+    check(near(lr.getModel().getIntercept(), expected_intercept, 1e-3), name + " intercept matches least squares");
+}
+
+static void run(const string& name, void (*test)()) {
+    try {
+        test();
+    } catch (const exception& e) {
+        cerr << "FAILED: " << name << " threw: " << e.what() << endl;
+        ++failures;
+    }
+}
+
+int main() {
+    run("plain reaches least squares", [] { testReachesLeastSquares(Optimizer::Plain); });
+    run("momentum reaches least squares", [] { testReachesLeastSquares(Optimizer::Momentum); });
+    run("nesterov reaches least squares", [] { testReachesLeastSquares(Optimizer::Nesterov); });
+    run("adam reaches least squares", [] { testReachesLeastSquares(Optimizer::Adam); });
+    run("armijo reaches least squares", [] { testReachesLeastSquares(Optimizer::Armijo); });
+
+    if (failures > 0) {
+        cerr << failures << " check(s) failed" << endl;
+        return 1;
+    }
+    cout << "All gradient descent optimizer checks passed" << endl;
+    return 0;
+}
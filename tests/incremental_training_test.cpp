@@ -0,0 +1,210 @@
+// Streaming points into windowed models and then calling trainModel() must
+// keep the streamed state instead of retraining from the (empty or stale)
+// dataset, and the train command must report the metrics of the window or
+// decayed fit rather than of every loaded row.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -pthread -DLR_NO_MAIN tests/incremental_training_test.cpp -o incremental_training_test
+//   ./incremental_training_test
+
+#include "../main.cpp"
+
+static int failures = 0;
+
+static void check(bool condition, const string& what) {
+    if (!condition) {
+        cerr << "FAILED: " << what << endl;
+        ++failures;
+    }
+}
+
+static bool near(double a, double b) {
+    return abs(a - b) <= 1e-9 * max(1.0, abs(b));
+}
+
+// Least squares on the last `count` points of y = slope * x + intercept + wobble
+static void expectedFit(size_t total, size_t count, double& slope, double& intercept) {
+    Dataset window;
+    for (size_t i = total - count; i < total; ++i) {
+        double x = static_cast<double>(i);
+        window.addDataPoint(x, (i < total / 2 ? 2.0 : -3.0) * x + 5.0 + (i % 3));
+    }
+    LeastSquaresModel model;
+    model.train(window);
+    slope = model.getSlope();
+    intercept = model.getIntercept();
+}
+
+static void streamPoints(LinearRegression& lr, size_t total) {
+    for (size_t i = 0; i < total; ++i) {
+        double x = static_cast<double>(i);
+        lr.addDataPoint(x, (i < total / 2 ? 2.0 : -3.0) * x + 5.0 + (i % 3));
+    }
+}
+
+static void testSlidingWindowKeepsStreamedState() {
+    LinearRegression lr;
+    lr.setVerbose(false);
+    lr.useSlidingWindow(50);
+    streamPoints(lr, 1000);
+
+    double slope = lr.getModel().getSlope();
+    double intercept = lr.getModel().getIntercept();
+    lr.trainModel();
+
+    double expected_slope, expected_intercept;
+    expectedFit(1000, 50, expected_slope, expected_intercept);
+    check(lr.isModelTrained(), "window model is trained after trainModel()");
+    check(near(lr.getModel().getSlope(), slope), "trainModel() keeps the window slope");
+    check(near(lr.getModel().getIntercept(), intercept), "trainModel() keeps the window intercept");
+    check(near(lr.getModel().getSlope(), expected_slope), "window slope matches least squares on the last points");
+    check(near(lr.getModel().getIntercept(), expected_intercept), "window intercept matches least squares on the last points");
+}
+
+static void testSlidingWindowIgnoresStaleDataset() {
+    LinearRegression lr;
+    lr.setVerbose(false);
+    lr.addDataPoints(vector<double>{0, 1, 2, 3}, vector<double>{100, 90, 80, 70});
+    lr.useSlidingWindow(50);
+    streamPoints(lr, 1000);
+    lr.trainModel();
+
+    double expected_slope, expected_intercept;
+    expectedFit(1000, 50, expected_slope, expected_intercept);
+    check(near(lr.getModel().getSlope(), expected_slope), "stale dataset rows do not replace the window");
+    check(near(lr.getModel().getIntercept(), expected_intercept), "stale dataset intercept is ignored");
+}
+
+static void testDecayedModelKeepsStreamedState() {
+    LinearRegression lr;
+    lr.setVerbose(false);
+    lr.useExponentialDecay(0.99);
+    streamPoints(lr, 1000);
+
+    double slope = lr.getModel().getSlope();
+    double intercept = lr.getModel().getIntercept();
+    bool threw = false;
+    try {
+        lr.trainModel();
+    } catch (const exception&) {
+        threw = true;
+    }
+    check(!threw, "trainModel() on a streamed decayed model does not throw");
+    check(near(lr.getModel().getSlope(), slope), "trainModel() keeps the decayed slope");
+    check(near(lr.getModel().getIntercept(), intercept), "trainModel() keeps the decayed intercept");
+}
+
+static void testTooFewStreamedPoints() {
+    LinearRegression lr;
+    lr.setVerbose(false);
+    lr.useSlidingWindow(10);
+    lr.addDataPoint(1.0, 2.0);
+
+    bool threw = false;
+    try {
+        lr.trainModel();
+    } catch (const exception&) {
+        threw = true;
+    }
+    check(threw, "trainModel() with one streamed point reports insufficient data");
+}
+
+// The drifting series above as a CSV file for the train command
+static string writeDriftingCSV(size_t total) {
+    string filename = (filesystem::temp_directory_path() / "incremental_training_test.csv").string();
+    ofstream out(filename, ios::trunc);
+    out << setprecision(17) << "x,y\n";
+    for (size_t i = 0; i < total; ++i) {
+        double x = static_cast<double>(i);
+        out << x << ',' << (i < total / 2 ? 2.0 : -3.0) * x + 5.0 + (i % 3) << '\n';
+    }
+    return filename;
+}
+
+// Run `train ... --format json` and return the summary line
+static string trainSummaryJSON(const vector<string>& arguments) {
+    vector<string> args = {"lr", "train", "--format", "json"};
+    args.insert(args.end(), arguments.begin(), arguments.end());
+    vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    
+    // The command turns off stdio sync, which replaces cout's buffer; do it
+    // first so the redirect below survives
+    ios::sync_with_stdio(false);
+    stringstream captured;
+    streambuf* original = cout.rdbuf(captured.rdbuf());
+    int status = runTrainCommand(static_cast<int>(argv.size()), argv.data());
+    cout.rdbuf(original);
+    check(status == EXIT_CODE_OK, "train command succeeds");
+    return captured.str();
+}
+
+static double jsonNumber(const string& json, const string& key) {
+    size_t pos = json.find("\"" + key + "\": ");
+    if (pos == string::npos) {
+        return numeric_limits<double>::quiet_NaN();
+    }
+    return strtod(json.c_str() + pos + key.size() + 4, nullptr);
+}
+
+static void testTrainCommandReportsWindowMetrics() {
+    string filename = writeDriftingCSV(1000);
+    string json = trainSummaryJSON({"--method", "window", "--window", "50", filename});
+    
+    Dataset window;
+    for (size_t i = 950; i < 1000; ++i) {
+        double x = static_cast<double>(i);
+        window.addDataPoint(x, -3.0 * x + 5.0 + (i % 3));
+    }
+    LeastSquaresModel model;
+    model.train(window);
+    RegressionMetrics expected = model.evaluate(window);
+    
+    check(jsonNumber(json, "metrics_rows") == 50, "window summary covers the window rows");
+    check(near(jsonNumber(json, "mse"), expected.mse), "window summary MSE is the window fit's");
+    check(near(jsonNumber(json, "r_squared"), expected.r_squared), "window summary R-squared is the window fit's");
+    check(near(jsonNumber(json, "max_error"), expected.max_error), "window summary max error is the window's");
+    filesystem::remove(filename);
+}
+
+static void testTrainCommandReportsDecayedMetrics() {
+    string filename = writeDriftingCSV(1000);
+    string json = trainSummaryJSON({"--method", "decay", "--decay", "0.98", filename});
+    
+    LinearRegression lr;
+    lr.setVerbose(false);
+    lr.useExponentialDecay(0.98);
+    streamPoints(lr, 1000);
+    
+    check(jsonNumber(json, "metrics_rows") == 1000, "decay summary covers every row");
+    check(near(jsonNumber(json, "mse"), lr.getModel().getMSE()), "decay summary MSE is the weighted fit's");
+    check(near(jsonNumber(json, "r_squared"), lr.getModel().getRSquared()), "decay summary R-squared is the weighted fit's");
+    filesystem::remove(filename);
+}
+
+static void run(const string& name, void (*test)()) {
+    try {
+        test();
+    } catch (const exception& e) {
+        cerr << "FAILED: " << name << " threw: " << e.what() << endl;
+        ++failures;
+    }
+}
+
+int main() {
+    run("sliding window keeps streamed state", testSlidingWindowKeepsStreamedState);
+    run("sliding window ignores stale dataset", testSlidingWindowIgnoresStaleDataset);
+    run("decayed model keeps streamed state", testDecayedModelKeepsStreamedState);
+    run("too few streamed points", testTooFewStreamedPoints);
+    run("train command reports window metrics", testTrainCommandReportsWindowMetrics);
+    run("train command reports decayed metrics", testTrainCommandReportsDecayedMetrics);
+
+    if (failures > 0) {
+        cerr << failures << " check(s) failed" << endl;
+        return 1;
+    }
+    cout << "All incremental training checks passed" << endl;
+    return 0;
+}